@@ -1,4 +1,5 @@
 #include "DataStore.h"
+#include "SimTrace.h"
 
 #include <QCoreApplication>
 #include <QDir>
@@ -7,6 +8,9 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QDateTime>
+#include <QDataStream>
+
+#include <atomic>
 
 static QJsonObject creatureToJson(const CreatureSettings& c)
 {
@@ -86,16 +90,116 @@ static CreatureSettings creatureFromJson(const QJsonObject& obj)
     return c;
 }
 
+static QJsonObject statsToJson(const StatsPyramid& stats)
+{
+    QJsonObject obj;
+    obj["ticks"] = stats.tickCount();
+    obj["channels"] = stats.channelCount();
+    obj["capacity"] = stats.capacity();
+    obj["fanout"] = stats.fanout();
+
+    QJsonArray levels;
+    for (int l = 0; l < stats.levelCount(); ++l) {
+        QJsonObject level;
+        level["width"] = stats.level(l).width;
+        level["firstBucket"] = stats.firstBucket(l);
+
+        QJsonArray sums;
+        QJsonArray mins;
+        QJsonArray maxs;
+        for (int bucket = stats.firstBucket(l); bucket < stats.endBucket(l); ++bucket) {
+            for (int c = 0; c < stats.channelCount(); ++c) {
+                sums.append(stats.value(l, bucket, c, StatsPyramid::Stat::Sum));
+                mins.append(stats.value(l, bucket, c, StatsPyramid::Stat::Min));
+                maxs.append(stats.value(l, bucket, c, StatsPyramid::Stat::Max));
+            }
+        }
+        level["sum"] = sums;
+        level["min"] = mins;
+        level["max"] = maxs;
+        levels.append(level);
+    }
+    obj["levels"] = levels;
+    return obj;
+}
+
+static QJsonObject allocationsToJson(const AllocationCounters& counters)
+{
+    QJsonObject obj;
+    obj["allocations"] = static_cast<double>(counters.allocations);
+    obj["bytes"] = static_cast<double>(counters.bytes);
+    return obj;
+}
+
+static QJsonObject memoryToJson(const MemoryReport& memory)
+{
+    QJsonObject obj;
+    obj["heapCounted"] = memory.heapCounted;
+    obj["ticks"] = memory.ticks;
+
+    QJsonObject phases;
+    for (int phase = 0; phase < MemoryReport::PhaseCount; ++phase) {
+        phases[MemoryReport::phaseName(phase)] = allocationsToJson(memory.phases[phase]);
+    }
+    obj["phases"] = phases;
+    obj["total"] = allocationsToJson(memory.total());
+    obj["peakTickAllocations"] = static_cast<double>(memory.peakTickAllocations);
+    obj["peakTick"] = memory.peakTick;
+    obj["scratch"] = allocationsToJson(memory.scratch);
+    obj["scratchPeakBytes"] = static_cast<double>(memory.scratchPeakBytes);
+    obj["peakCreatures"] = memory.peakCreatures;
+    obj["peakFood"] = memory.peakFood;
+    obj["bytesPerCreature"] = memory.bytesPerCreature;
+    obj["bytesPerFood"] = memory.bytesPerFood;
+    obj["peakResidentBytes"] = static_cast<double>(memory.peakResidentBytes);
+    return obj;
+}
+
+static QJsonObject countersToJson(const CounterReport& counters)
+{
+    QJsonObject obj;
+    obj["ticks"] = counters.ticks;
+    if (!counters.unavailableReason.empty()) {
+        obj["unavailableReason"] = QString::fromStdString(counters.unavailableReason);
+    }
+
+    QJsonObject phases;
+    for (int phase = 0; phase < CounterReport::PhaseCount; ++phase) {
+        QJsonObject entry;
+        for (int counter = 0; counter < CounterValues::CounterCount; ++counter) {
+            if (counters.has(static_cast<CounterValues::Counter>(counter))) {
+                entry[CounterValues::counterName(counter)] = static_cast<double>(counters.phases[phase].values[counter]);
+            }
+        }
+        if (counters.has(CounterValues::Cycles) && counters.has(CounterValues::Instructions)) {
+            entry["ipc"] = counters.ipc(phase);
+        }
+        phases[CounterReport::phaseName(phase)] = entry;
+    }
+    obj["phases"] = phases;
+    return obj;
+}
+
 static QJsonObject resultToJson(const SimulationResult& result)
 {
     QJsonObject root;
     root["videoFile"] = result.videoFile;
     root["datetime"] = result.datetime;
     root["status"] = result.status;
+    root["stopReason"] = result.stopReason;
+    root["ticksSimulated"] = result.ticksSimulated;
+    root["budgetHits"] = static_cast<qint64>(result.budgetHits);
+    root["birthsRefused"] = result.birthsRefused;
     root["nodeType"] = result.nodeType;
     root["duration"] = result.duration;
     root["computeCost"] = result.computeCost;
     root["resultSize"] = result.resultSize;
+    if (result.memory.enabled) {
+        root["memory"] = memoryToJson(result.memory);
+    }
+    if (result.counters.enabled) {
+        root["counters"] = countersToJson(result.counters);
+    }
 
     QJsonArray creatureCount;
     for (double v : result.creatureCount) {
@@ -153,9 +257,36 @@ static QJsonObject resultToJson(const SimulationResult& result)
         }
         s["deaths"] = deaths;
 
+        QJsonArray traits;
+        for (const auto& trait : series.traits) {
+            QJsonObject t;
+            t["name"] = trait.name;
+            t["lower"] = trait.lower;
+            t["upper"] = trait.upper;
+
+            QJsonArray mean;
+            for (double v : trait.mean) {
+                mean.append(v);
+            }
+            t["mean"] = mean;
+
+            QJsonArray histograms;
+            for (const auto& histogram : trait.histograms) {
+                QJsonArray bins;
+                for (int v : histogram) {
+                    bins.append(v);
+                }
+                histograms.append(bins);
+            }
+            t["histograms"] = histograms;
+            traits.append(t);
+        }
+        s["traits"] = traits;
+
         speciesArray.append(s);
     }
     root["species"] = speciesArray;
+    root["stats"] = statsToJson(result.stats);
 
     return root;
 }
@@ -183,15 +314,19 @@ QString DataStore::outputDir()
 
 QString DataStore::outputVideoPath()
 {
-    const QString name = QString("simulation_%1.mp4")
-                             .arg(QDateTime::currentMSecsSinceEpoch());
+    // Concurrent jobs can start within the same millisecond, in this process or in
+    // another worker process; the pid and counter keep names unique.
+    static std::atomic_int sequence{ 0 };
+    const QString name = QString("simulation_%1_%2_%3.mp4")
+                             .arg(QDateTime::currentMSecsSinceEpoch())
+                             .arg(QCoreApplication::applicationPid())
+                             .arg(sequence.fetch_add(1));
     QDir dir(outputDir());
     return dir.filePath(name);
 }
 
-bool DataStore::saveCreatures(const SimulationSettings& sim,
-                              const QVector<CreatureSettings>& creatures,
-                              QString* error)
+static QJsonObject scenarioToJson(const SimulationSettings& sim,
+                                  const QVector<CreatureSettings>& creatures)
 {
     QJsonObject root;
     QJsonObject simObj;
@@ -199,6 +334,25 @@ bool DataStore::saveCreatures(const SimulationSettings& sim,
     simObj["foodRespawnMultiplier"] = sim.foodRespawnMultiplier;
     simObj["foodRespawnBase"] = sim.foodRespawnBase;
     simObj["foodEnergy"] = sim.foodEnergy;
+    simObj["chartBins"] = sim.chartBins;
+    simObj["worldWidth"] = sim.worldWidth;
+    simObj["worldHeight"] = sim.worldHeight;
+    simObj["lodInterval"] = sim.lodInterval;
+    simObj["worldStrips"] = sim.worldStrips;
+    simObj["perceptionRadius"] = sim.perceptionRadius;
+    simObj["sensingRadius"] = sim.sensingRadius;
+    simObj["reorderInterval"] = sim.reorderInterval;
+    simObj["reorderDisorder"] = sim.reorderDisorder;
+    simObj["memoryTelemetry"] = sim.memoryTelemetry;
+    simObj["hardwareCounters"] = sim.hardwareCounters;
+    simObj["stopOnExtinction"] = sim.stopOnExtinction;
+    simObj["stopWhenExtinct"] = QJsonArray::fromStringList(sim.stopWhenExtinct);
+    simObj["steadyStateWindow"] = sim.steadyStateWindow;
+    simObj["steadyStateTolerance"] = sim.steadyStateTolerance;
+    simObj["maxCreatures"] = sim.maxCreatures;
+    simObj["maxFood"] = sim.maxFood;
+    simObj["memoryBudgetMb"] = sim.memoryBudgetMb;
+    simObj["budgetSuppressBirths"] = sim.budgetSuppressBirths;
     root["simulationSettings"] = simObj;
 
     QJsonArray creatureArray;
@@ -206,8 +360,57 @@ bool DataStore::saveCreatures(const SimulationSettings& sim,
         creatureArray.append(creatureToJson(creature));
     }
     root["creatures"] = creatureArray;
+    return root;
+}
+
+static void scenarioFromJson(const QJsonObject& root,
+                             SimulationSettings& sim,
+                             QVector<CreatureSettings>& creatures)
+{
+    QJsonObject simObj = root.value("simulationSettings").toObject();
+    sim.simLength = simObj.value("simLength").toInt(sim.simLength);
+    sim.foodRespawnMultiplier = simObj.value("foodRespawnMultiplier").toDouble(sim.foodRespawnMultiplier);
+    sim.foodRespawnBase = simObj.value("foodRespawnBase").toDouble(sim.foodRespawnBase);
+    sim.foodEnergy = simObj.value("foodEnergy").toDouble(sim.foodEnergy);
+    sim.chartBins = simObj.value("chartBins").toInt(sim.chartBins);
+    sim.worldWidth = simObj.value("worldWidth").toInt(sim.worldWidth);
+    sim.worldHeight = simObj.value("worldHeight").toInt(sim.worldHeight);
+    sim.lodInterval = simObj.value("lodInterval").toInt(sim.lodInterval);
+    sim.worldStrips = simObj.value("worldStrips").toInt(sim.worldStrips);
+    sim.perceptionRadius = simObj.value("perceptionRadius").toDouble(sim.perceptionRadius);
+    sim.sensingRadius = simObj.value("sensingRadius").toDouble(sim.sensingRadius);
+    sim.reorderInterval = simObj.value("reorderInterval").toInt(sim.reorderInterval);
+    sim.reorderDisorder = simObj.value("reorderDisorder").toDouble(sim.reorderDisorder);
+    sim.memoryTelemetry = simObj.value("memoryTelemetry").toBool(sim.memoryTelemetry);
+    sim.hardwareCounters = simObj.value("hardwareCounters").toBool(sim.hardwareCounters);
+    sim.stopOnExtinction = simObj.value("stopOnExtinction").toBool(sim.stopOnExtinction);
+    if (simObj.contains("stopWhenExtinct")) {
+        sim.stopWhenExtinct.clear();
+        for (const auto& item : simObj.value("stopWhenExtinct").toArray()) {
+            sim.stopWhenExtinct.push_back(item.toString());
+        }
+    }
+    sim.steadyStateWindow = simObj.value("steadyStateWindow").toInt(sim.steadyStateWindow);
+    sim.steadyStateTolerance = simObj.value("steadyStateTolerance").toDouble(sim.steadyStateTolerance);
+    sim.maxCreatures = simObj.value("maxCreatures").toInt(sim.maxCreatures);
+    sim.maxFood = simObj.value("maxFood").toInt(sim.maxFood);
+    sim.memoryBudgetMb = simObj.value("memoryBudgetMb").toInt(sim.memoryBudgetMb);
+    sim.budgetSuppressBirths = simObj.value("budgetSuppressBirths").toBool(sim.budgetSuppressBirths);
 
-    QJsonDocument doc(root);
+    creatures.clear();
+    for (const auto& item : root.value("creatures").toArray()) {
+        if (item.isObject()) {
+            creatures.push_back(creatureFromJson(item.toObject()));
+        }
+    }
+}
+
+bool DataStore::saveCreatures(const SimulationSettings& sim,
+                              const QVector<CreatureSettings>& creatures,
+                              QString* error)
+{
+    SimTrace::Span trace("io", "DataStore::saveCreatures");
+    QJsonDocument doc(scenarioToJson(sim, creatures));
     QFile file(QDir(dataDir()).filePath("creatures.json"));
     if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
         if (error) {
@@ -224,6 +427,7 @@ bool DataStore::loadCreatures(SimulationSettings& sim,
                               QVector<CreatureSettings>& creatures,
                               QString* error)
 {
+    SimTrace::Span trace("io", "DataStore::loadCreatures");
     QFile file(QDir(dataDir()).filePath("creatures.json"));
     if (!file.exists()) {
         if (error) {
@@ -247,23 +451,40 @@ bool DataStore::loadCreatures(SimulationSettings& sim,
         return false;
     }
 
-    QJsonObject root = doc.object();
-    QJsonObject simObj = root.value("simulationSettings").toObject();
-    sim.simLength = simObj.value("simLength").toInt(sim.simLength);
-    sim.foodRespawnMultiplier = simObj.value("foodRespawnMultiplier").toDouble(sim.foodRespawnMultiplier);
-    sim.foodRespawnBase = simObj.value("foodRespawnBase").toDouble(sim.foodRespawnBase);
-    sim.foodEnergy = simObj.value("foodEnergy").toDouble(sim.foodEnergy);
+    scenarioFromJson(doc.object(), sim, creatures);
+    if (creatures.isEmpty()) {
+        if (error) {
+            *error = "No creatures stored in creatures.json.";
+        }
+        return false;
+    }
 
-    creatures.clear();
-    for (const auto& item : root.value("creatures").toArray()) {
-        if (item.isObject()) {
-            creatures.push_back(creatureFromJson(item.toObject()));
+    return true;
+}
+
+QByteArray DataStore::serializeScenario(const SimulationSettings& sim,
+                                        const QVector<CreatureSettings>& creatures)
+{
+    return QJsonDocument(scenarioToJson(sim, creatures)).toJson(QJsonDocument::Compact);
+}
+
+bool DataStore::deserializeScenario(const QByteArray& data,
+                                    SimulationSettings& sim,
+                                    QVector<CreatureSettings>& creatures,
+                                    QString* error)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (!doc.isObject()) {
+        if (error) {
+            *error = "Invalid scenario format.";
         }
+        return false;
     }
 
+    scenarioFromJson(doc.object(), sim, creatures);
     if (creatures.isEmpty()) {
         if (error) {
-            *error = "No creatures stored in creatures.json.";
+            *error = "Scenario has no creatures.";
         }
         return false;
     }
@@ -273,6 +494,7 @@ bool DataStore::loadCreatures(SimulationSettings& sim,
 
 bool DataStore::saveResult(const SimulationResult& result, QString* error)
 {
+    SimTrace::Span trace("io", "DataStore::saveResult");
     QFile file(QDir(dataDir()).filePath("last_result.json"));
     if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
         if (error) {
@@ -288,6 +510,230 @@ bool DataStore::saveResult(const SimulationResult& result, QString* error)
 
 QByteArray DataStore::serializeResult(const SimulationResult& result)
 {
+    SimTrace::Span trace("io", "DataStore::serializeResult");
     QJsonDocument doc(resultToJson(result));
     return doc.toJson(QJsonDocument::Compact);
 }
+
+// Binary result layout: magic, format version, then the fields of
+// SimulationResult in declaration order via QDataStream (Qt 6.0 encoding).
+// The stats pyramid is stored as its raw levels so it restores exactly; the
+// level arrays are copied in host byte order, which is fine for local pipes.
+static constexpr quint32 kResultMagic = 0x43535231; // "CSR1"
+static constexpr quint32 kResultVersion = 5;
+
+static void writeAllocations(QDataStream& out, const AllocationCounters& counters)
+{
+    out << quint64(counters.allocations) << quint64(counters.bytes);
+}
+
+static void readAllocations(QDataStream& in, AllocationCounters& counters)
+{
+    quint64 allocations = 0;
+    quint64 bytes = 0;
+    in >> allocations >> bytes;
+    counters.allocations = allocations;
+    counters.bytes = bytes;
+}
+
+QByteArray DataStore::serializeResultBinary(const SimulationResult& result)
+{
+    SimTrace::Span trace("io", "DataStore::serializeResultBinary");
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    out << kResultMagic << kResultVersion;
+    out << result.videoFile
+        << result.creatureCount << result.foodCount << result.birthCount << result.deathCount
+        << qint32(result.deathAge) << qint32(result.deathHunger) << qint32(result.deathPredation);
+
+    out << qint32(result.species.size());
+    for (const auto& series : result.species) {
+        out << series.name << series.color << series.count << series.births << series.deaths;
+        out << qint32(series.traits.size());
+        for (const auto& trait : series.traits) {
+            out << trait.name << trait.lower << trait.upper << trait.histograms << trait.mean;
+        }
+    }
+
+    const StatsPyramid& stats = result.stats;
+    out << qint32(stats.channelCount()) << qint32(stats.capacity()) << qint32(stats.fanout())
+        << qint32(stats.tickCount()) << qint32(stats.levelCount());
+    for (int l = 0; l < stats.levelCount(); ++l) {
+        const StatsPyramid::Level& level = stats.level(l);
+        out << qint32(level.width);
+        for (const auto* values : { &level.sums, &level.mins, &level.maxs }) {
+            out << quint32(values->size());
+            out.writeRawData(reinterpret_cast<const char*>(values->data()),
+                             static_cast<int>(values->size() * sizeof(double)));
+        }
+    }
+
+    const MemoryReport& memory = result.memory;
+    out << memory.enabled << memory.heapCounted << qint32(memory.ticks);
+    for (const auto& phase : memory.phases) {
+        writeAllocations(out, phase);
+    }
+    out << quint64(memory.peakTickAllocations) << qint32(memory.peakTick);
+    writeAllocations(out, memory.scratch);
+    out << quint64(memory.scratchPeakBytes) << qint32(memory.peakCreatures) << qint32(memory.peakFood)
+        << memory.bytesPerCreature << memory.bytesPerFood << quint64(memory.peakResidentBytes);
+
+    const CounterReport& counters = result.counters;
+    out << counters.enabled << quint32(counters.available)
+        << QString::fromStdString(counters.unavailableReason) << qint32(counters.ticks);
+    for (const auto& phase : counters.phases) {
+        for (std::uint64_t value : phase.values) {
+            out << quint64(value);
+        }
+    }
+
+    out << result.stopReason << qint32(result.ticksSimulated) << result.budgetHits << result.birthsRefused;
+
+    out << result.duration << result.computeCost << result.resultSize
+        << result.datetime << result.status << result.nodeType << result.failureReason;
+    return data;
+}
+
+bool DataStore::deserializeResultBinary(const QByteArray& data, SimulationResult& result, QString* error)
+{
+    SimTrace::Span trace("io", "DataStore::deserializeResultBinary");
+    auto fail = [error](const QString& reason) {
+        if (error) {
+            *error = reason;
+        }
+        return false;
+    };
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != kResultMagic) {
+        return fail("Not a binary simulation result.");
+    }
+    if (version != kResultVersion) {
+        return fail(QString("Unsupported result format version %1.").arg(version));
+    }
+
+    SimulationResult out;
+    qint32 deathAge = 0;
+    qint32 deathHunger = 0;
+    qint32 deathPredation = 0;
+    in >> out.videoFile
+       >> out.creatureCount >> out.foodCount >> out.birthCount >> out.deathCount
+       >> deathAge >> deathHunger >> deathPredation;
+    out.deathAge = deathAge;
+    out.deathHunger = deathHunger;
+    out.deathPredation = deathPredation;
+
+    qint32 speciesCount = 0;
+    in >> speciesCount;
+    if (speciesCount < 0 || in.status() != QDataStream::Ok) {
+        return fail("Corrupt result header.");
+    }
+    for (qint32 i = 0; i < speciesCount && in.status() == QDataStream::Ok; ++i) {
+        SpeciesSeries series;
+        in >> series.name >> series.color >> series.count >> series.births >> series.deaths;
+        qint32 traitCount = 0;
+        in >> traitCount;
+        for (qint32 t = 0; t < traitCount && in.status() == QDataStream::Ok; ++t) {
+            TraitSeries trait;
+            in >> trait.name >> trait.lower >> trait.upper >> trait.histograms >> trait.mean;
+            series.traits.push_back(trait);
+        }
+        out.species.push_back(series);
+    }
+
+    qint32 channels = 0;
+    qint32 capacity = 0;
+    qint32 fanout = 0;
+    qint32 ticks = 0;
+    qint32 levelCount = 0;
+    in >> channels >> capacity >> fanout >> ticks >> levelCount;
+    if (in.status() != QDataStream::Ok || channels < 0 || capacity <= 0 || fanout < 2 || levelCount < 0) {
+        return fail("Corrupt result statistics.");
+    }
+
+    std::vector<StatsPyramid::Level> levels;
+    for (qint32 l = 0; l < levelCount && in.status() == QDataStream::Ok; ++l) {
+        StatsPyramid::Level level;
+        qint32 width = 0;
+        in >> width;
+        level.width = width;
+        for (auto* values : { &level.sums, &level.mins, &level.maxs }) {
+            quint32 size = 0;
+            in >> size;
+            if (size != static_cast<quint32>(capacity) * static_cast<quint32>(channels)) {
+                return fail("Corrupt result statistics.");
+            }
+            values->resize(size);
+            const int bytes = static_cast<int>(size * sizeof(double));
+            if (in.readRawData(reinterpret_cast<char*>(values->data()), bytes) != bytes) {
+                return fail("Truncated result statistics.");
+            }
+        }
+        levels.push_back(std::move(level));
+    }
+
+    out.stats = StatsPyramid(channels, capacity, fanout);
+    if (levelCount > 0 && !out.stats.restore(ticks, std::move(levels))) {
+        return fail("Result statistics do not match their declared shape.");
+    }
+
+    MemoryReport& memory = out.memory;
+    qint32 memoryTicks = 0;
+    in >> memory.enabled >> memory.heapCounted >> memoryTicks;
+    memory.ticks = memoryTicks;
+    for (auto& phase : memory.phases) {
+        readAllocations(in, phase);
+    }
+    quint64 peakTickAllocations = 0;
+    qint32 peakTick = 0;
+    in >> peakTickAllocations >> peakTick;
+    memory.peakTickAllocations = peakTickAllocations;
+    memory.peakTick = peakTick;
+    readAllocations(in, memory.scratch);
+    quint64 scratchPeakBytes = 0;
+    qint32 peakCreatures = 0;
+    qint32 peakFood = 0;
+    quint64 peakResidentBytes = 0;
+    in >> scratchPeakBytes >> peakCreatures >> peakFood
+       >> memory.bytesPerCreature >> memory.bytesPerFood >> peakResidentBytes;
+    memory.scratchPeakBytes = scratchPeakBytes;
+    memory.peakCreatures = peakCreatures;
+    memory.peakFood = peakFood;
+    memory.peakResidentBytes = peakResidentBytes;
+
+    CounterReport& counters = out.counters;
+    quint32 available = 0;
+    QString unavailableReason;
+    qint32 counterTicks = 0;
+    in >> counters.enabled >> available >> unavailableReason >> counterTicks;
+    counters.available = available;
+    counters.unavailableReason = unavailableReason.toStdString();
+    counters.ticks = counterTicks;
+    for (auto& phase : counters.phases) {
+        for (std::uint64_t& value : phase.values) {
+            quint64 stored = 0;
+            in >> stored;
+            value = stored;
+        }
+    }
+
+    qint32 ticksSimulated = 0;
+    in >> out.stopReason >> ticksSimulated >> out.budgetHits >> out.birthsRefused;
+    out.ticksSimulated = ticksSimulated;
+
+    in >> out.duration >> out.computeCost >> out.resultSize
+       >> out.datetime >> out.status >> out.nodeType >> out.failureReason;
+    if (in.status() != QDataStream::Ok) {
+        return fail("Truncated simulation result.");
+    }
+
+    result = out;
+    return true;
+}
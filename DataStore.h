@@ -18,6 +18,15 @@ public:
                               QVector<CreatureSettings>& creatures,
                               QString* error);
 
+    static QByteArray serializeScenario(const SimulationSettings& sim,
+                                        const QVector<CreatureSettings>& creatures);
+    static bool deserializeScenario(const QByteArray& data,
+                                    SimulationSettings& sim,
+                                    QVector<CreatureSettings>& creatures,
+                                    QString* error);
+
     static bool saveResult(const SimulationResult& result, QString* error);
     static QByteArray serializeResult(const SimulationResult& result);
+    static QByteArray serializeResultBinary(const SimulationResult& result);
+    static bool deserializeResultBinary(const QByteArray& data, SimulationResult& result, QString* error);
 };
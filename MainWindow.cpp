@@ -3,6 +3,9 @@
 #include "DataStore.h"
 #include "ResultsWindow.h"
 #include "SimEnvironment.h"
+#include "SimStopConditions.h"
+#include "SimTrace.h"
+#include "WorkerPool.h"
 
 #include <QApplication>
 #include <QVBoxLayout>
@@ -11,6 +14,11 @@
 #include <QGroupBox>
 #include <QLabel>
 #include <QPushButton>
+#include <QListWidget>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QThreadPool>
+#include <QRunnable>
 #include <QSpinBox>
 #include <QDoubleSpinBox>
 #include <QScrollArea>
@@ -42,12 +50,25 @@ void SimWorker::setInputs(const SimulationSettings& sim,
 
 void SimWorker::requestStop()
 {
+    m_stopRequestedAt.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
     m_stopRequested.store(true, std::memory_order_relaxed);
 }
 
 void SimWorker::run()
 {
-    m_stopRequested.store(false, std::memory_order_relaxed);
+    // A job cancelled while still queued finishes without starting ffmpeg.
+    if (m_stopRequested.load(std::memory_order_relaxed)) {
+        SimulationResult result;
+        result.datetime = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        result.status = "cancelled";
+        result.stopReason = "cancelled";
+        result.nodeType = "local";
+        result.failureReason = "Simulation cancelled before it started.";
+        emit finishedWithResult(result);
+        return;
+    }
+
+    SimTrace::setThreadName("simulation worker");
     SimulationResult result = runSimulation(m_sim, m_creatures);
     emit finishedWithResult(result);
 }
@@ -84,13 +105,20 @@ static QByteArray generateFrame(const Environment& environment, int width, int h
 {
     QByteArray frame(width * height * 3, char(0));
 
+    // The world is scaled to fit the video frame; entities never shrink below a pixel.
+    const double scale = std::min(width / static_cast<double>(std::max(1, environment.width)),
+        height / static_cast<double>(std::max(1, environment.height)));
+    auto radius = [scale](double size) {
+        return std::max(1, static_cast<int>(std::round(size * scale)));
+    };
+
     for (const auto* food : environment.foods) {
         drawCircle(frame,
             width,
             height,
-            static_cast<int>(std::round(food->x())),
-            static_cast<int>(std::round(food->y())),
-            static_cast<int>(std::round(food->size())),
+            static_cast<int>(std::round(food->x() * scale)),
+            static_cast<int>(std::round(food->y() * scale)),
+            radius(food->size()),
             QColor(255, 255, 255));
     }
 
@@ -98,10 +126,10 @@ static QByteArray generateFrame(const Environment& environment, int width, int h
         drawCircle(frame,
             width,
             height,
-            static_cast<int>(std::round(creature->x)),
-            static_cast<int>(std::round(creature->y)),
-            static_cast<int>(std::round(creature->size)),
-            QColor(creature->colorR, creature->colorG, creature->colorB));
+            static_cast<int>(std::round(creature->x * scale)),
+            static_cast<int>(std::round(creature->y * scale)),
+            radius(creature->size),
+            QColor(creature->species->colorR, creature->species->colorG, creature->species->colorB));
     }
 
     return frame;
@@ -113,21 +141,59 @@ SimulationResult SimWorker::runSimulation(const SimulationSettings& sim,
     SimulationResult out;
     out.datetime = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
     out.status = "success";
+    out.stopReason = StopConditions::reasonName(StopConditions::None);
     out.nodeType = "local";
 
+    // Video frame size; the simulated world may be larger and is scaled down to fit.
     const int width = 1280;
     const int height = 720;
     const int fps = 30;
 
-    const int binSize = std::max(1, static_cast<int>(std::ceil(sim.simLength / 80.0)));
+    const QString conflict = Environment::speciesConflict(creatures);
+    if (!conflict.isEmpty()) {
+        out.status = "failed";
+        out.stopReason = "failed";
+        out.failureReason = conflict;
+        return out;
+    }
+
+    const int chartBins = std::max(1, sim.chartBins);
+    const int binSize = std::max(1, static_cast<int>(std::ceil(sim.simLength / static_cast<double>(chartBins))));
 
     Environment environment(sim.foodRespawnBase,
         sim.foodRespawnMultiplier,
         sim.foodEnergy,
-        width,
-        height);
+        std::max(1, sim.worldWidth),
+        std::max(1, sim.worldHeight));
+    environment.lodInterval = std::max(1, sim.lodInterval);
+    environment.stripCount = std::max(1, sim.worldStrips);
+    environment.perceptionRadius = std::max(0.0, sim.perceptionRadius);
+    environment.sensingRadius = std::max(0.0, sim.sensingRadius);
+    environment.reorderInterval = std::max(0, sim.reorderInterval);
+    environment.reorderDisorder = std::max(0.0, sim.reorderDisorder);
+    environment.budget.maxCreatures = std::max(0, sim.maxCreatures);
+    environment.budget.maxFood = std::max(0, sim.maxFood);
+    environment.budget.maxBytes = static_cast<std::size_t>(std::max(0, sim.memoryBudgetMb)) * 1024 * 1024;
+    environment.budget.mode = sim.budgetSuppressBirths ? PopulationBudget::SuppressBirths : PopulationBudget::StopRun;
+    environment.stopFlag = &m_stopRequested;
+    MemoryTelemetry telemetry;
+    if (sim.memoryTelemetry) {
+        environment.memoryTelemetry = &telemetry;
+    }
+    CounterTelemetry counters;
+    CounterTelemetry* countersUsed = sim.hardwareCounters ? &counters : nullptr;
+    environment.counterTelemetry = countersUsed;
     environment.setupFood();
     environment.setupCreatures(creatures);
+    out.budgetHits = environment.budgetHits;
+    // A setup already clamped by the budget would not be the run that was asked for.
+    if (out.budgetHits != 0 && environment.budget.mode == PopulationBudget::StopRun) {
+        out.status = "failed";
+        out.stopReason = PopulationBudget::limitName(out.budgetHits);
+        out.failureReason = QString("The initial setup exceeds the budget (%1); lower the initial populations or raise the limit.")
+                                .arg(out.stopReason);
+        return out;
+    }
 
     struct SpeciesBinData {
         int count = 0;
@@ -142,12 +208,45 @@ SimulationResult SimWorker::runSimulation(const SimulationSettings& sim,
             SpeciesSeries series;
             series.name = creature.speciesName;
             series.color = QColor(creature.colorR, creature.colorG, creature.colorB);
+            const int envIndex = static_cast<int>(out.species.size());
+            for (int trait = 0; trait < TraitHistograms::TraitCount; ++trait) {
+                TraitSeries traitSeries;
+                traitSeries.name = TraitHistograms::traitName(trait);
+                traitSeries.lower = environment.traits.lower(envIndex, trait);
+                traitSeries.upper = environment.traits.upper(envIndex, trait);
+                series.traits.push_back(traitSeries);
+            }
             out.species.push_back(series);
             speciesIndex.insert(creature.speciesName, out.species.size() - 1);
             speciesBin.insert(creature.speciesName, SpeciesBinData());
         }
     }
 
+    StopConditionSettings stopSettings;
+    stopSettings.anySpeciesExtinct = sim.stopOnExtinction;
+    QStringList unknownSpecies;
+    for (const QString& name : sim.stopWhenExtinct) {
+        if (speciesIndex.contains(name)) {
+            stopSettings.extinctSet.push_back(speciesIndex.value(name));
+        } else {
+            unknownSpecies.push_back(name);
+        }
+    }
+    // A misspelt name would otherwise silently disable the condition.
+    if (!unknownSpecies.isEmpty()) {
+        out.status = "failed";
+        out.stopReason = "failed";
+        out.failureReason = QString("\"Stop when extinct\" names species that are not configured: %1.")
+                                .arg(unknownSpecies.join(", "));
+        return out;
+    }
+    stopSettings.steadyWindow = sim.steadyStateWindow;
+    stopSettings.steadyTolerance = sim.steadyStateTolerance;
+    StopConditions stopConditions(stopSettings, static_cast<int>(out.species.size()));
+
+    out.stats = StatsPyramid(StatsSpeciesBase + static_cast<int>(out.species.size()));
+    std::vector<double> tickStats(out.stats.channelCount(), 0.0);
+
     double creatureCountBin = 0.0;
     double foodCountBin = 0.0;
     double birthCountBin = 0.0;
@@ -175,6 +274,7 @@ SimulationResult SimWorker::runSimulation(const SimulationSettings& sim,
     ffmpeg.start("ffmpeg", args, QIODevice::WriteOnly);
     if (!ffmpeg.waitForStarted()) {
         out.status = "failed";
+        out.stopReason = "failed";
         out.failureReason = "Failed to start ffmpeg process.";
         out.videoFile.clear();
         return out;
@@ -183,19 +283,57 @@ SimulationResult SimWorker::runSimulation(const SimulationSettings& sim,
     QElapsedTimer timer;
     timer.start();
 
+    // Progress is reported at most every 250 ms so the GUI queue never floods.
+    constexpr qint64 progressIntervalMs = 250;
+    qint64 lastProgressMs = -progressIntervalMs;
+
     for (int i = 0; i < sim.simLength; ++i) {
+        Tracking tracking(&environment.scratch);
+        environment.update(tracking);
+        CounterTelemetry::PhaseMeter tickCounters(countersUsed, CounterReport::PhaseStats);
+        out.ticksSimulated = i + 1;
+        out.budgetHits |= environment.budgetHits;
+        out.birthsRefused += environment.birthsRefused;
+
         if (m_stopRequested.load(std::memory_order_relaxed)) {
+            const qint64 latency = QDateTime::currentMSecsSinceEpoch() - m_stopRequestedAt.load(std::memory_order_relaxed);
             out.status = "cancelled";
-            out.failureReason = "Simulation cancelled.";
+            out.stopReason = "cancelled";
+            out.failureReason = QString("Simulation cancelled at tick %1 (stopped %2 ms after request).")
+                                    .arg(i + 1)
+                                    .arg(std::max<qint64>(0, latency));
             break;
         }
 
-        Tracking tracking;
-        environment.update(tracking);
+        const qint64 elapsedMs = timer.elapsed();
+        if (elapsedMs - lastProgressMs >= progressIntervalMs) {
+            lastProgressMs = elapsedMs;
+            SimulationProgress report;
+            report.tick = i + 1;
+            report.totalTicks = sim.simLength;
+            report.ticksPerSecond = elapsedMs > 0 ? report.tick * 1000.0 / elapsedMs : 0.0;
+            report.population = static_cast<int>(environment.creatures.size());
+            report.etaSeconds = report.ticksPerSecond > 0.0
+                ? (report.totalTicks - report.tick) / report.ticksPerSecond
+                : 0.0;
+            emit progress(report);
+        }
 
-        if (environment.creatures.empty()) {
+        // Extinction keeps its old behaviour of dropping the partial bin; the other
+        // conditions flush it and render the final frame before stopping.
+        const StopConditions::Reason stop = stopConditions.check(environment.traits, i + 1);
+        if (stop != StopConditions::None) {
+            out.stopReason = StopConditions::reasonName(stop);
+        }
+        if (stop == StopConditions::AllExtinct) {
             break;
         }
+        // Over budget the tick's allocations were already refused; stop after recording it.
+        const bool overBudget = environment.budgetHits != 0 && environment.budget.mode == PopulationBudget::StopRun;
+        if (overBudget && stop == StopConditions::None) {
+            out.stopReason = PopulationBudget::limitName(environment.budgetHits);
+        }
+        const bool stopping = stop != StopConditions::None || overBudget;
 
         creatureCountBin += environment.creatures.size();
         foodCountBin += environment.foods.size();
@@ -207,22 +345,18 @@ SimulationResult SimWorker::runSimulation(const SimulationSettings& sim,
 
         for (auto it = speciesIndex.constBegin(); it != speciesIndex.constEnd(); ++it) {
             const QString& speciesName = it.key();
-            int speciesCount = 0;
+            // Environment assigns species indices in the same first-seen order as out.species.
+            const int speciesCount = environment.traits.population(it.value());
             int speciesBirths = 0;
             int speciesDeaths = 0;
 
-            for (const auto* creature : environment.creatures) {
-                if (creature->speciesName == speciesName) {
-                    speciesCount += 1;
-                }
-            }
-            for (const auto& birth : tracking.births) {
-                if (birth == speciesName) {
+            for (int birth : tracking.births) {
+                if (birth == it.value()) {
                     speciesBirths += 1;
                 }
             }
-            for (const auto& death : tracking.deaths) {
-                if (death == speciesName) {
+            for (int death : tracking.deaths) {
+                if (death == it.value()) {
                     speciesDeaths += 1;
                 }
             }
@@ -231,11 +365,18 @@ SimulationResult SimWorker::runSimulation(const SimulationSettings& sim,
             bin.count += speciesCount;
             bin.births += speciesBirths;
             bin.deaths += speciesDeaths;
+            tickStats[StatsSpeciesBase + it.value()] = speciesCount;
         }
 
+        tickStats[StatsCreatures] = environment.creatures.size();
+        tickStats[StatsFood] = environment.foods.size();
+        tickStats[StatsBirths] = tracking.births.size();
+        tickStats[StatsDeaths] = tracking.deaths.size();
+        out.stats.record(tickStats);
+
         binCounter += 1;
 
-        if (binCounter == binSize || i == sim.simLength - 1) {
+        if (binCounter == binSize || i == sim.simLength - 1 || stopping) {
             const double divisor = static_cast<double>(std::max(1, binCounter));
             out.creatureCount.push_back(creatureCountBin / divisor);
             out.foodCount.push_back(foodCountBin / divisor);
@@ -253,6 +394,13 @@ SimulationResult SimWorker::runSimulation(const SimulationSettings& sim,
                 out.species[index].births.push_back(bin.births);
                 out.species[index].deaths.push_back(bin.deaths);
                 speciesBin[speciesName] = SpeciesBinData();
+
+                for (int trait = 0; trait < TraitHistograms::TraitCount; ++trait) {
+                    const std::vector<int>& counts = environment.traits.counts(index, trait);
+                    TraitSeries& traitSeries = out.species[index].traits[trait];
+                    traitSeries.histograms.push_back(QVector<int>(counts.begin(), counts.end()));
+                    traitSeries.mean.push_back(environment.traits.mean(index, trait));
+                }
             }
 
             creatureCountBin = 0.0;
@@ -263,26 +411,45 @@ SimulationResult SimWorker::runSimulation(const SimulationSettings& sim,
             binCounter = 0;
         }
 
+        tickCounters.next(CounterReport::PhaseRender);
+        SimTrace::Span trace("video", "render");
         const QByteArray frame = generateFrame(environment, width, height);
+        trace.next("ffmpeg write");
         const qint64 written = ffmpeg.write(frame);
         if (written == -1) {
             out.status = "failed";
+            out.stopReason = "failed";
             out.failureReason = "Failed to write frame to ffmpeg.";
             break;
         }
         if (written < frame.size()) {
             ffmpeg.waitForBytesWritten(-1);
         }
+        if (stopping) {
+            break;
+        }
     }
 
-    ffmpeg.closeWriteChannel();
-    ffmpeg.waitForFinished(-1);
+    {
+        SimTrace::Span trace("video", "ffmpeg finish");
+        ffmpeg.closeWriteChannel();
+        ffmpeg.waitForFinished(-1);
+    }
 
     if (ffmpeg.exitStatus() != QProcess::NormalExit || ffmpeg.exitCode() != 0) {
         out.status = "failed";
+        out.stopReason = "failed";
         out.failureReason = "ffmpeg exited with an error.";
     }
 
+    if (sim.memoryTelemetry) {
+        telemetry.finish();
+        out.memory = telemetry.report();
+    }
+    if (sim.hardwareCounters) {
+        out.counters = counters.report();
+    }
+
     out.duration = timer.elapsed() / 1000.0;
     out.computeCost = (0.096 / 3600.0) * out.duration;
     out.resultSize = 0.0;
@@ -367,6 +534,95 @@ MainWindow::MainWindow(QWidget* parent)
     foodEnergy->setSingleStep(1.0);
     foodEnergy->setValue(15.0);
 
+    chartBins = new QSpinBox();
+    chartBins->setRange(1, 100'000);
+    chartBins->setSingleStep(10);
+    chartBins->setValue(80);
+
+    worldWidth = new QSpinBox();
+    worldWidth->setRange(64, 1'000'000);
+    worldWidth->setSingleStep(128);
+    worldWidth->setValue(1280);
+
+    worldHeight = new QSpinBox();
+    worldHeight->setRange(64, 1'000'000);
+    worldHeight->setSingleStep(72);
+    worldHeight->setValue(720);
+
+    lodInterval = new QSpinBox();
+    lodInterval->setRange(1, 64);
+    lodInterval->setValue(1);
+
+    worldStrips = new QSpinBox();
+    worldStrips->setRange(1, 256);
+    worldStrips->setValue(1);
+
+    perceptionRadius = new QDoubleSpinBox();
+    perceptionRadius->setRange(0.0, 100'000.0);
+    perceptionRadius->setSingleStep(10.0);
+    perceptionRadius->setValue(160.0);
+
+    sensingRadius = new QDoubleSpinBox();
+    sensingRadius->setRange(0.0, 100'000.0);
+    sensingRadius->setSingleStep(10.0);
+    sensingRadius->setSpecialValueText("Unlimited");
+    sensingRadius->setValue(0.0);
+
+    reorderInterval = new QSpinBox();
+    reorderInterval->setRange(0, 1'000'000);
+    reorderInterval->setSingleStep(10);
+    reorderInterval->setSpecialValueText("Off");
+    reorderInterval->setValue(0);
+
+    reorderDisorder = new QDoubleSpinBox();
+    reorderDisorder->setRange(0.0, 1.0);
+    reorderDisorder->setDecimals(2);
+    reorderDisorder->setSingleStep(0.05);
+    reorderDisorder->setSpecialValueText("Off");
+    reorderDisorder->setValue(0.0);
+
+    memoryTelemetry = new QCheckBox("Record allocations and memory footprint");
+
+    hardwareCounters = new QCheckBox("Record CPU counters per phase (Linux perf)");
+
+    stopOnExtinction = new QCheckBox("Stop when any species dies out");
+
+    stopWhenExtinct = new QLineEdit();
+    stopWhenExtinct->setPlaceholderText("Species names, comma separated");
+
+    steadyStateWindow = new QSpinBox();
+    steadyStateWindow->setRange(0, 1'000'000);
+    steadyStateWindow->setSingleStep(100);
+    steadyStateWindow->setSpecialValueText("Off");
+    steadyStateWindow->setValue(0);
+
+    steadyStateTolerance = new QDoubleSpinBox();
+    steadyStateTolerance->setRange(0.0, 1.0);
+    steadyStateTolerance->setDecimals(3);
+    steadyStateTolerance->setSingleStep(0.005);
+    steadyStateTolerance->setValue(0.02);
+
+    maxCreatures = new QSpinBox();
+    maxCreatures->setRange(0, 100'000'000);
+    maxCreatures->setSingleStep(1000);
+    maxCreatures->setSpecialValueText("No limit");
+    maxCreatures->setValue(0);
+
+    maxFood = new QSpinBox();
+    maxFood->setRange(0, 100'000'000);
+    maxFood->setSingleStep(1000);
+    maxFood->setSpecialValueText("No limit");
+    maxFood->setValue(0);
+
+    memoryBudgetMb = new QSpinBox();
+    memoryBudgetMb->setRange(0, 1'000'000);
+    memoryBudgetMb->setSingleStep(256);
+    memoryBudgetMb->setSuffix(" MB");
+    memoryBudgetMb->setSpecialValueText("No limit");
+    memoryBudgetMb->setValue(4096);
+
+    budgetSuppressBirths = new QCheckBox("Suppress births near the limit instead of stopping");
+
     simGrid->addWidget(new QLabel("Simulation Length"), 0, 0);
     simGrid->addWidget(simLength, 0, 1);
     simGrid->addWidget(new QLabel("Food Respawn Multiplier"), 1, 0);
@@ -375,6 +631,44 @@ MainWindow::MainWindow(QWidget* parent)
     simGrid->addWidget(foodRespawnBase, 2, 1);
     simGrid->addWidget(new QLabel("Energy per Food"), 3, 0);
     simGrid->addWidget(foodEnergy, 3, 1);
+    simGrid->addWidget(new QLabel("Chart Bins"), 4, 0);
+    simGrid->addWidget(chartBins, 4, 1);
+    simGrid->addWidget(new QLabel("World Width"), 5, 0);
+    simGrid->addWidget(worldWidth, 5, 1);
+    simGrid->addWidget(new QLabel("World Height"), 6, 0);
+    simGrid->addWidget(worldHeight, 6, 1);
+    simGrid->addWidget(new QLabel("Idle Update Interval"), 7, 0);
+    simGrid->addWidget(lodInterval, 7, 1);
+    simGrid->addWidget(new QLabel("World Strips"), 8, 0);
+    simGrid->addWidget(worldStrips, 8, 1);
+    simGrid->addWidget(new QLabel("Strip Perception Radius"), 9, 0);
+    simGrid->addWidget(perceptionRadius, 9, 1);
+    simGrid->addWidget(new QLabel("Memory Telemetry"), 10, 0);
+    simGrid->addWidget(memoryTelemetry, 10, 1);
+    simGrid->addWidget(new QLabel("Performance Counters"), 11, 0);
+    simGrid->addWidget(hardwareCounters, 11, 1);
+    simGrid->addWidget(new QLabel("Stop on Extinction"), 12, 0);
+    simGrid->addWidget(stopOnExtinction, 12, 1);
+    simGrid->addWidget(new QLabel("Stop When Extinct"), 13, 0);
+    simGrid->addWidget(stopWhenExtinct, 13, 1);
+    simGrid->addWidget(new QLabel("Steady-State Window"), 14, 0);
+    simGrid->addWidget(steadyStateWindow, 14, 1);
+    simGrid->addWidget(new QLabel("Steady-State Tolerance"), 15, 0);
+    simGrid->addWidget(steadyStateTolerance, 15, 1);
+    simGrid->addWidget(new QLabel("Creature Budget"), 16, 0);
+    simGrid->addWidget(maxCreatures, 16, 1);
+    simGrid->addWidget(new QLabel("Food Budget"), 17, 0);
+    simGrid->addWidget(maxFood, 17, 1);
+    simGrid->addWidget(new QLabel("Memory Budget"), 18, 0);
+    simGrid->addWidget(memoryBudgetMb, 18, 1);
+    simGrid->addWidget(new QLabel("Budget Mode"), 19, 0);
+    simGrid->addWidget(budgetSuppressBirths, 19, 1);
+    simGrid->addWidget(new QLabel("Spatial Reorder Interval"), 20, 0);
+    simGrid->addWidget(reorderInterval, 20, 1);
+    simGrid->addWidget(new QLabel("Spatial Reorder Disorder"), 21, 0);
+    simGrid->addWidget(reorderDisorder, 21, 1);
+    simGrid->addWidget(new QLabel("Sensing Radius"), 22, 0);
+    simGrid->addWidget(sensingRadius, 22, 1);
 
     root->addWidget(simBox);
 
@@ -410,25 +704,53 @@ MainWindow::MainWindow(QWidget* parent)
     connect(saveCreaturesBtn, &QPushButton::clicked, this, &MainWindow::onSaveCreatures);
     connect(loadCreaturesBtn, &QPushButton::clicked, this, &MainWindow::onLoadCreatures);
 
-    startBtn = new QPushButton("Start Simulation");
+    startBtn = new QPushButton("Queue Simulation");
     startBtn->setMinimumHeight(46);
     connect(startBtn, &QPushButton::clicked, this, &MainWindow::onStartSimulation);
     root->addWidget(startBtn);
 
+    auto* jobsBox = new QGroupBox("Simulation Jobs");
+    auto* jobsLayout = new QVBoxLayout(jobsBox);
+    jobsLayout->setContentsMargins(12, 16, 12, 16);
+    jobsLayout->setSpacing(10);
+
+    jobPool = new QThreadPool(this);
+    jobPool->setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+    jobPoolLabel = new QLabel(QString("Running up to %1 simulations at once.").arg(jobPool->maxThreadCount()));
+    jobsLayout->addWidget(jobPoolLabel);
+
+    isolateJobsCheck = new QCheckBox("Run each job in a separate worker process");
+    isolateJobsCheck->setToolTip("A crashing scenario only takes down its worker, which is restarted.");
+    jobsLayout->addWidget(isolateJobsCheck);
+
+    jobList = new QListWidget();
+    jobList->setMinimumHeight(140);
+    jobsLayout->addWidget(jobList);
+    connect(jobList, &QListWidget::itemSelectionChanged, this, &MainWindow::onJobSelectionChanged);
+    connect(jobList, &QListWidget::itemDoubleClicked, this, &MainWindow::onOpenJobResult);
+
+    auto* jobBtnRow = new QHBoxLayout();
+    jobBtnRow->setSpacing(10);
+    cancelJobBtn = new QPushButton("Cancel Job");
+    openResultBtn = new QPushButton("Open Result");
+    cancelJobBtn->setEnabled(false);
+    openResultBtn->setEnabled(false);
+    jobBtnRow->addWidget(cancelJobBtn);
+    jobBtnRow->addWidget(openResultBtn);
+    jobsLayout->addLayout(jobBtnRow);
+
+    connect(cancelJobBtn, &QPushButton::clicked, this, &MainWindow::onCancelJob);
+    connect(openResultBtn, &QPushButton::clicked, this, &MainWindow::onOpenJobResult);
+
+    root->addWidget(jobsBox);
+
     addCreaturePanel();
     resize(1200, 900);
 }
 
 MainWindow::~MainWindow()
 {
-    if (simWorker) {
-        simWorker->requestStop();
-    }
-
-    if (simThread) {
-        simThread->quit();
-        simThread->wait(1500);
-    }
+    stopAllJobs();
 }
 
 void MainWindow::addCreaturePanel(const CreatureSettings& settings)
@@ -453,6 +775,29 @@ SimulationSettings MainWindow::collectSimulationSettings() const
     s.foodRespawnMultiplier = foodRespawnMultiplier->value();
     s.foodRespawnBase = foodRespawnBase->value();
     s.foodEnergy = foodEnergy->value();
+    s.chartBins = chartBins->value();
+    s.worldWidth = worldWidth->value();
+    s.worldHeight = worldHeight->value();
+    s.lodInterval = lodInterval->value();
+    s.worldStrips = worldStrips->value();
+    s.perceptionRadius = perceptionRadius->value();
+    s.sensingRadius = sensingRadius->value();
+    s.reorderInterval = reorderInterval->value();
+    s.reorderDisorder = reorderDisorder->value();
+    s.memoryTelemetry = memoryTelemetry->isChecked();
+    s.hardwareCounters = hardwareCounters->isChecked();
+    s.stopOnExtinction = stopOnExtinction->isChecked();
+    for (const QString& name : stopWhenExtinct->text().split(',', Qt::SkipEmptyParts)) {
+        if (!name.trimmed().isEmpty()) {
+            s.stopWhenExtinct.push_back(name.trimmed());
+        }
+    }
+    s.steadyStateWindow = steadyStateWindow->value();
+    s.steadyStateTolerance = steadyStateTolerance->value();
+    s.maxCreatures = maxCreatures->value();
+    s.maxFood = maxFood->value();
+    s.memoryBudgetMb = memoryBudgetMb->value();
+    s.budgetSuppressBirths = budgetSuppressBirths->isChecked();
     return s;
 }
 
@@ -471,6 +816,25 @@ void MainWindow::setSimulationSettings(const SimulationSettings& settings)
     foodRespawnMultiplier->setValue(settings.foodRespawnMultiplier);
     foodRespawnBase->setValue(settings.foodRespawnBase);
     foodEnergy->setValue(settings.foodEnergy);
+    chartBins->setValue(settings.chartBins);
+    worldWidth->setValue(settings.worldWidth);
+    worldHeight->setValue(settings.worldHeight);
+    lodInterval->setValue(settings.lodInterval);
+    worldStrips->setValue(settings.worldStrips);
+    perceptionRadius->setValue(settings.perceptionRadius);
+    sensingRadius->setValue(settings.sensingRadius);
+    reorderInterval->setValue(settings.reorderInterval);
+    reorderDisorder->setValue(settings.reorderDisorder);
+    memoryTelemetry->setChecked(settings.memoryTelemetry);
+    hardwareCounters->setChecked(settings.hardwareCounters);
+    stopOnExtinction->setChecked(settings.stopOnExtinction);
+    stopWhenExtinct->setText(settings.stopWhenExtinct.join(", "));
+    steadyStateWindow->setValue(settings.steadyStateWindow);
+    steadyStateTolerance->setValue(settings.steadyStateTolerance);
+    maxCreatures->setValue(settings.maxCreatures);
+    maxFood->setValue(settings.maxFood);
+    memoryBudgetMb->setValue(settings.memoryBudgetMb);
+    budgetSuppressBirths->setChecked(settings.budgetSuppressBirths);
 }
 
 void MainWindow::setCreatureSettings(const QVector<CreatureSettings>& creatures)
@@ -515,10 +879,6 @@ void MainWindow::onLoadCreatures()
 
 void MainWindow::onStartSimulation()
 {
-    if (simThread && simThread->isRunning()) {
-        return;
-    }
-
     SimulationSettings sim = collectSimulationSettings();
     QVector<CreatureSettings> creatures = collectCreatureSettings();
     if (creatures.isEmpty()) {
@@ -526,37 +886,200 @@ void MainWindow::onStartSimulation()
         return;
     }
 
-    simThread = new QThread(this);
-    simWorker = new SimWorker();
-    simWorker->setInputs(sim, creatures);
-    simWorker->moveToThread(simThread);
+    QStringList speciesNames;
+    for (const auto& creature : creatures) {
+        if (!speciesNames.contains(creature.speciesName)) {
+            speciesNames.push_back(creature.speciesName);
+        }
+    }
 
-    connect(simThread, &QThread::started, simWorker, &SimWorker::run);
-    connect(simWorker, &SimWorker::finishedWithResult, this, &MainWindow::onSimFinished);
-    connect(simWorker, &SimWorker::finishedWithResult, simThread, &QThread::quit);
-    connect(simThread, &QThread::finished, simWorker, &QObject::deleteLater);
-    connect(simThread, &QThread::finished, simThread, &QObject::deleteLater);
+    QStringList unknownSpecies;
+    for (const QString& name : sim.stopWhenExtinct) {
+        if (!speciesNames.contains(name)) {
+            unknownSpecies.push_back(name);
+        }
+    }
+    if (!unknownSpecies.isEmpty()) {
+        QMessageBox::warning(this, "Unknown Species",
+            QString("\"Stop when extinct\" names species that are not configured: %1.").arg(unknownSpecies.join(", ")));
+        return;
+    }
 
-    startBtn->setEnabled(false);
-    simThread->start();
+    SimJob job;
+    job.id = nextJobId++;
+    job.name = QString("%1 (%2 ticks)").arg(speciesNames.join(", ")).arg(sim.simLength);
+    job.state = "queued";
+    job.progress.totalTicks = sim.simLength;
+    job.isolated = isolateJobsCheck->isChecked();
+
+    if (job.isolated) {
+        if (!workerPool) {
+            workerPool = new WorkerPool(jobPool->maxThreadCount(), this);
+            connect(workerPool, &WorkerPool::jobProgress, this, &MainWindow::onJobProgress);
+            connect(workerPool, &WorkerPool::jobFinished, this, &MainWindow::onJobFinished);
+        }
+
+        jobs.push_back(job);
+        jobList->addItem(QString());
+        updateJobRow(jobs.back());
+        workerPool->submit(job.id, sim, creatures);
+        return;
+    }
+
+    job.worker = new SimWorker();
+    job.worker->setInputs(sim, creatures);
+
+    // The worker lives on the GUI thread; its signals are emitted from a pool
+    // thread, so these connections are queued back to the window.
+    const int jobId = job.id;
+    connect(job.worker, &SimWorker::progress, this, [this, jobId](const SimulationProgress& progress) {
+        onJobProgress(jobId, progress);
+    });
+    connect(job.worker, &SimWorker::finishedWithResult, this, [this, jobId](const SimulationResult& result) {
+        onJobFinished(jobId, result);
+    });
+
+    jobs.push_back(job);
+    jobList->addItem(QString());
+    updateJobRow(jobs.back());
+
+    SimWorker* worker = job.worker;
+    jobPool->start(QRunnable::create([worker]() { worker->run(); }));
+}
+
+void MainWindow::onJobProgress(int jobId, const SimulationProgress& progress)
+{
+    SimJob* job = findJob(jobId);
+    if (!job) {
+        return;
+    }
+
+    if (job->state == "queued") {
+        job->state = "running";
+    }
+    job->progress = progress;
+    updateJobRow(*job);
+}
+
+void MainWindow::onJobFinished(int jobId, const SimulationResult& result)
+{
+    SimJob* job = findJob(jobId);
+    if (!job) {
+        return;
+    }
+
+    job->result = result;
+    job->state = result.status;
+    job->done = true;
+    if (job->worker) {
+        job->worker->deleteLater();
+        job->worker = nullptr;
+    }
+    updateJobRow(*job);
+    onJobSelectionChanged();
+}
+
+void MainWindow::onCancelJob()
+{
+    const int row = jobList->currentRow();
+    if (row < 0 || row >= jobs.size() || jobs[row].done) {
+        return;
+    }
+
+    jobs[row].state = "cancelling";
+    updateJobRow(jobs[row]);
+    onJobSelectionChanged();
+    if (jobs[row].isolated) {
+        workerPool->cancel(jobs[row].id);
+    } else {
+        jobs[row].worker->requestStop();
+    }
 }
 
-void MainWindow::onSimFinished(const SimulationResult& result)
+void MainWindow::onOpenJobResult()
 {
-    startBtn->setEnabled(true);
-    simThread = nullptr;
-    simWorker = nullptr;
+    const int row = jobList->currentRow();
+    if (row < 0 || row >= jobs.size() || !jobs[row].done) {
+        return;
+    }
 
     if (!resultsWindow) {
         resultsWindow = new ResultsWindow();
         connect(resultsWindow, &ResultsWindow::backRequested, this, &MainWindow::onBackFromResults);
     }
 
-    resultsWindow->setResult(result);
+    resultsWindow->setResult(jobs[row].result);
     resultsWindow->show();
     hide();
 }
 
+void MainWindow::onJobSelectionChanged()
+{
+    const int row = jobList->currentRow();
+    const bool valid = row >= 0 && row < jobs.size();
+    const bool active = valid && !jobs[row].done && jobs[row].state != "cancelling";
+    cancelJobBtn->setEnabled(active);
+    openResultBtn->setEnabled(valid && jobs[row].done);
+}
+
+SimJob* MainWindow::findJob(int jobId)
+{
+    for (auto& job : jobs) {
+        if (job.id == jobId) {
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+void MainWindow::updateJobRow(const SimJob& job)
+{
+    const int row = static_cast<int>(&job - jobs.constData());
+    QListWidgetItem* item = jobList->item(row);
+    if (!item) {
+        return;
+    }
+
+    QString detail;
+    if (job.state == "queued") {
+        detail = "queued";
+    } else if (job.state == "running" || job.state == "cancelling") {
+        const SimulationProgress& p = job.progress;
+        const int percent = p.totalTicks > 0 ? (100 * p.tick) / p.totalTicks : 0;
+        detail = QString("%1 %2% | tick %3 / %4 | %5 ticks/s | population %6 | about %7 s left")
+                     .arg(job.state)
+                     .arg(percent)
+                     .arg(p.tick)
+                     .arg(p.totalTicks)
+                     .arg(p.ticksPerSecond, 0, 'f', 1)
+                     .arg(p.population)
+                     .arg(std::ceil(p.etaSeconds), 0, 'f', 0);
+    } else if (job.result.failureReason.isEmpty()) {
+        detail = QString("%1 in %2 s").arg(job.state).arg(job.result.duration, 0, 'f', 1);
+        if (!job.result.stopReason.isEmpty()
+            && job.result.stopReason != StopConditions::reasonName(StopConditions::None)) {
+            detail += QString(", %1 at tick %2").arg(job.result.stopReason).arg(job.result.ticksSimulated);
+        }
+    } else {
+        detail = QString("%1: %2").arg(job.state, job.result.failureReason);
+    }
+    if (job.done && !job.result.nodeType.isEmpty()) {
+        detail += QString(" [%1]").arg(job.result.nodeType);
+    }
+
+    item->setText(QString("#%1  %2  -  %3").arg(job.id).arg(job.name, detail));
+}
+
+void MainWindow::stopAllJobs()
+{
+    for (auto& job : jobs) {
+        if (job.worker) {
+            job.worker->requestStop();
+        }
+    }
+    jobPool->waitForDone(5000);
+}
+
 void MainWindow::onBackFromResults()
 {
     if (resultsWindow) {
@@ -568,14 +1091,6 @@ void MainWindow::onBackFromResults()
 
 void MainWindow::closeEvent(QCloseEvent* event)
 {
-    if (simWorker) {
-        simWorker->requestStop();
-    }
-
-    if (simThread) {
-        simThread->quit();
-        simThread->wait(1500);
-    }
-
+    stopAllJobs();
     event->accept();
 }
@@ -5,21 +5,56 @@
 #include <QVector>
 #include <QColor>
 #include <QString>
+#include <QStringList>
 #include <atomic>
 
+#include "SimStats.h"
+#include "SimMemory.h"
+#include "SimCounters.h"
+
 class QSpinBox;
 class QDoubleSpinBox;
 class QPushButton;
+class QLabel;
+class QListWidget;
+class QThreadPool;
+class QCheckBox;
+class QLineEdit;
 class QVBoxLayout;
 
 class CreaturePanel;
 class ResultsWindow;
+class WorkerPool;
 
 struct SimulationSettings {
     int simLength = 5400;
     double foodRespawnMultiplier = 1.0;
     double foodRespawnBase = 1.0;
     double foodEnergy = 15.0;
+    int chartBins = 80;
+    int worldWidth = 1280;
+    int worldHeight = 720;
+    int lodInterval = 1;
+    int worldStrips = 1;
+    double perceptionRadius = 160.0;
+    // How far creatures sense threats, mates and food; 0 senses everything visible.
+    double sensingRadius = 0.0;
+    // Spatial reordering of creature storage; 0 disables each trigger.
+    int reorderInterval = 0;
+    double reorderDisorder = 0.0;
+    bool memoryTelemetry = false;
+    bool hardwareCounters = false;
+    // Early termination; all creatures dying out always ends the run.
+    bool stopOnExtinction = false;
+    QStringList stopWhenExtinct;
+    int steadyStateWindow = 0;
+    double steadyStateTolerance = 0.02;
+    // Allocation budgets; 0 disables a limit. Hitting one stops the run unless
+    // budgetSuppressBirths switches to density-dependent birth suppression.
+    int maxCreatures = 0;
+    int maxFood = 0;
+    int memoryBudgetMb = 4096;
+    bool budgetSuppressBirths = false;
 };
 
 struct CreatureSettings {
@@ -61,12 +96,32 @@ struct CreatureSettings {
     double fleeRecoveryFactor = 10.0;
 };
 
+// Distribution of one heritable trait, snapshotted at the end of every bin.
+struct TraitSeries {
+    QString name;
+    double lower = 0.0;
+    double upper = 0.0;
+    QVector<QVector<int>> histograms;
+    QVector<double> mean;
+};
+
 struct SpeciesSeries {
     QString name;
     QColor color;
     QVector<double> count;
     QVector<double> births;
     QVector<double> deaths;
+    QVector<TraitSeries> traits;
+};
+
+// Channel layout of SimulationResult::stats. One species count channel follows
+// StatsSpeciesBase for every entry of SimulationResult::species.
+enum StatsChannel {
+    StatsCreatures = 0,
+    StatsFood,
+    StatsBirths,
+    StatsDeaths,
+    StatsSpeciesBase
 };
 
 struct SimulationResult {
@@ -79,6 +134,17 @@ struct SimulationResult {
     int deathHunger = 0;
     int deathPredation = 0;
     QVector<SpeciesSeries> species;
+    StatsPyramid stats;
+    // Filled when SimulationSettings::memoryTelemetry is set.
+    MemoryReport memory;
+    // Filled when SimulationSettings::hardwareCounters is set.
+    CounterReport counters;
+    // Why the run ended: "completed", a StopConditions::reasonName, "cancelled" or "failed".
+    QString stopReason;
+    int ticksSimulated = 0;
+    // PopulationBudget::Limit bits hit during the run and the newborns refused.
+    quint32 budgetHits = 0;
+    qint64 birthsRefused = 0;
     double duration = 0.0;
     double computeCost = 0.0;
     double resultSize = 0.0;
@@ -90,6 +156,16 @@ struct SimulationResult {
 
 Q_DECLARE_METATYPE(SimulationResult)
 
+struct SimulationProgress {
+    int tick = 0;
+    int totalTicks = 0;
+    double ticksPerSecond = 0.0;
+    int population = 0;
+    double etaSeconds = 0.0;
+};
+
+Q_DECLARE_METATYPE(SimulationProgress)
+
 class SimWorker : public QObject {
     Q_OBJECT
 public:
@@ -99,6 +175,7 @@ public:
     void requestStop();
 
 signals:
+    void progress(const SimulationProgress& progress);
     void finishedWithResult(const SimulationResult& result);
 
 public slots:
@@ -108,10 +185,22 @@ private:
     SimulationResult runSimulation(const SimulationSettings& sim, const QVector<CreatureSettings>& creatures);
 
     std::atomic_bool m_stopRequested{ false };
+    std::atomic<qint64> m_stopRequestedAt{ 0 };
     SimulationSettings m_sim;
     QVector<CreatureSettings> m_creatures;
 };
 
+struct SimJob {
+    int id = 0;
+    QString name;
+    QString state;
+    bool isolated = false;
+    bool done = false;
+    SimWorker* worker = nullptr;
+    SimulationProgress progress;
+    SimulationResult result;
+};
+
 class MainWindow : public QWidget {
     Q_OBJECT
 
@@ -127,7 +216,9 @@ private slots:
     void onSaveCreatures();
     void onLoadCreatures();
     void onStartSimulation();
-    void onSimFinished(const SimulationResult& result);
+    void onCancelJob();
+    void onOpenJobResult();
+    void onJobSelectionChanged();
     void onBackFromResults();
 
 private:
@@ -137,12 +228,36 @@ private:
     void setCreatureSettings(const QVector<CreatureSettings>& creatures);
     void addCreaturePanel(const CreatureSettings& settings = CreatureSettings());
     void clearCreaturePanels();
+    void onJobProgress(int jobId, const SimulationProgress& progress);
+    void onJobFinished(int jobId, const SimulationResult& result);
+    SimJob* findJob(int jobId);
+    void updateJobRow(const SimJob& job);
+    void stopAllJobs();
 
     // Simulation inputs
     QSpinBox* simLength = nullptr;
     QDoubleSpinBox* foodRespawnMultiplier = nullptr;
     QDoubleSpinBox* foodRespawnBase = nullptr;
     QDoubleSpinBox* foodEnergy = nullptr;
+    QSpinBox* chartBins = nullptr;
+    QSpinBox* worldWidth = nullptr;
+    QSpinBox* worldHeight = nullptr;
+    QSpinBox* lodInterval = nullptr;
+    QSpinBox* worldStrips = nullptr;
+    QDoubleSpinBox* perceptionRadius = nullptr;
+    QDoubleSpinBox* sensingRadius = nullptr;
+    QSpinBox* reorderInterval = nullptr;
+    QDoubleSpinBox* reorderDisorder = nullptr;
+    QCheckBox* memoryTelemetry = nullptr;
+    QCheckBox* hardwareCounters = nullptr;
+    QCheckBox* stopOnExtinction = nullptr;
+    QLineEdit* stopWhenExtinct = nullptr;
+    QSpinBox* steadyStateWindow = nullptr;
+    QDoubleSpinBox* steadyStateTolerance = nullptr;
+    QSpinBox* maxCreatures = nullptr;
+    QSpinBox* maxFood = nullptr;
+    QSpinBox* memoryBudgetMb = nullptr;
+    QCheckBox* budgetSuppressBirths = nullptr;
 
     // Creature list UI
     QVBoxLayout* creatureListLayout = nullptr;
@@ -154,9 +269,16 @@ private:
     QPushButton* loadCreaturesBtn = nullptr;
     QPushButton* startBtn = nullptr;
 
-    // Threading
-    QThread* simThread = nullptr;
-    SimWorker* simWorker = nullptr;
+    // Job queue
+    QListWidget* jobList = nullptr;
+    QLabel* jobPoolLabel = nullptr;
+    QCheckBox* isolateJobsCheck = nullptr;
+    QPushButton* cancelJobBtn = nullptr;
+    QPushButton* openResultBtn = nullptr;
+    QThreadPool* jobPool = nullptr;
+    WorkerPool* workerPool = nullptr;
+    QVector<SimJob> jobs;
+    int nextJobId = 1;
 
     // Results window
     ResultsWindow* resultsWindow = nullptr;
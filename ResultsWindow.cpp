@@ -1,5 +1,6 @@
 #include "ResultsWindow.h"
 #include "DataStore.h"
+#include "SimTrace.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -19,6 +20,102 @@
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QPieSeries>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace {
+constexpr int kMaxChartPoints = 600;
+
+// Replace the points of a series with the pyramid level best suited to the tick range.
+void fillFromStats(QLineSeries* series,
+    const StatsPyramid& stats,
+    int channel,
+    StatsPyramid::Stat stat,
+    double minTick,
+    double maxTick,
+    double& minValue,
+    double& maxValue)
+{
+    const int start = std::max(0, static_cast<int>(std::floor(minTick)));
+    const int end = std::max(start + 1, static_cast<int>(std::ceil(maxTick)) + 1);
+    const int level = stats.bestLevel(start, end, kMaxChartPoints);
+
+    std::vector<int> ticks;
+    const std::vector<double> values = stats.series(level, channel, stat, start, end, &ticks);
+    const double center = level >= 0 ? (stats.level(level).width - 1) / 2.0 : 0.0;
+
+    QList<QPointF> points;
+    points.reserve(static_cast<int>(values.size()));
+    for (size_t i = 0; i < values.size(); ++i) {
+        points.append(QPointF(ticks[i] + center, values[i]));
+        minValue = std::min(minValue, values[i]);
+        maxValue = std::max(maxValue, values[i]);
+    }
+    series->replace(points);
+}
+
+// Tick-resolution chart over the stats pyramid; rubber-band zooming re-reads finer levels.
+QChartView* makeStatsChart(const QString& title,
+    const std::shared_ptr<const StatsPyramid>& stats,
+    const QVector<int>& channels,
+    const QVector<QString>& names,
+    const QVector<QColor>& colors,
+    StatsPyramid::Stat stat)
+{
+    auto* chart = new QChart();
+    chart->setTitle(title);
+
+    auto* axisX = new QValueAxis();
+    axisX->setTitleText("Tick");
+    axisX->setLabelFormat("%d");
+    auto* axisY = new QValueAxis();
+    axisY->setTitleText("Value");
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+
+    QVector<QLineSeries*> seriesList;
+    for (int i = 0; i < channels.size(); ++i) {
+        auto* series = new QLineSeries();
+        series->setName(names.value(i));
+        series->setColor(colors.value(i));
+        chart->addSeries(series);
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+        seriesList.push_back(series);
+    }
+
+    auto refresh = [stats, channels, seriesList, axisY, stat](qreal minTick, qreal maxTick) {
+        double minValue = std::numeric_limits<double>::infinity();
+        double maxValue = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < seriesList.size(); ++i) {
+            fillFromStats(seriesList[i], *stats, channels[i], stat, minTick, maxTick, minValue, maxValue);
+        }
+        if (minValue <= maxValue) {
+            axisY->setRange(std::min(0.0, minValue), std::max(1.0, maxValue * 1.05));
+        }
+    };
+
+    const int maxTick = std::max(1, stats->tickCount() - 1);
+    axisX->setRange(0, maxTick);
+    refresh(0, maxTick);
+    QObject::connect(axisX, &QValueAxis::rangeChanged, chart, refresh);
+
+    if (channels.size() > 1) {
+        chart->legend()->setVisible(true);
+        chart->legend()->setAlignment(Qt::AlignTop);
+    } else {
+        chart->legend()->hide();
+    }
+
+    auto* view = new QChartView(chart);
+    view->setRenderHint(QPainter::Antialiasing);
+    view->setRubberBand(QChartView::HorizontalRubberBand);
+    return view;
+}
+}
+
 ResultsWindow::ResultsWindow(QWidget* parent)
     : QWidget(parent)
 {
@@ -146,6 +243,7 @@ void ResultsWindow::setResult(const SimulationResult& result)
 
 void ResultsWindow::buildCharts(const SimulationResult& result)
 {
+    SimTrace::Span trace("gui", "ResultsWindow::buildCharts");
     auto* grid = qobject_cast<QGridLayout*>(chartsContainer->layout());
     while (QLayoutItem* item = grid->takeAt(0)) {
         if (item->widget()) {
@@ -185,19 +283,100 @@ void ResultsWindow::buildCharts(const SimulationResult& result)
         return view;
     };
 
-    auto* creatureCountChart = makeLineChart("Total Creature Count", result.creatureCount, QColor(75, 192, 192));
-    grid->addWidget(creatureCountChart, 0, 0);
+    if (result.stats.tickCount() > 0) {
+        // Zoomable per-tick charts: drag to zoom into a tick range, right-click to zoom out.
+        const auto stats = std::make_shared<const StatsPyramid>(result.stats);
+        const auto mean = StatsPyramid::Stat::Mean;
+
+        grid->addWidget(makeStatsChart("Total Creature Count", stats, { StatsCreatures }, { "Creatures" },
+            { QColor(75, 192, 192) }, mean), 0, 0);
+        grid->addWidget(makeStatsChart("Food Count", stats, { StatsFood }, { "Food" },
+            { QColor(153, 102, 255) }, mean), 0, 1);
+        grid->addWidget(makeStatsChart("Births per Tick", stats, { StatsBirths }, { "Births" },
+            { QColor(0, 123, 255) }, mean), 1, 0);
+        grid->addWidget(makeStatsChart("Deaths per Tick", stats, { StatsDeaths }, { "Deaths" },
+            { QColor(255, 99, 132) }, mean), 1, 1);
+
+        QVector<int> speciesChannels;
+        QVector<QString> speciesNames;
+        QVector<QColor> speciesColors;
+        for (int i = 0; i < result.species.size(); ++i) {
+            speciesChannels.push_back(StatsSpeciesBase + i);
+            speciesNames.push_back(result.species[i].name);
+            speciesColors.push_back(result.species[i].color);
+        }
+        grid->addWidget(makeStatsChart("Species Count", stats, speciesChannels, speciesNames,
+            speciesColors, mean), 2, 0);
+    } else {
+        auto* creatureCountChart = makeLineChart("Total Creature Count", result.creatureCount, QColor(75, 192, 192));
+        grid->addWidget(creatureCountChart, 0, 0);
+
+        auto* foodChart = makeLineChart("Food Count", result.foodCount, QColor(153, 102, 255));
+        grid->addWidget(foodChart, 0, 1);
 
-    auto* foodChart = makeLineChart("Food Count", result.foodCount, QColor(153, 102, 255));
-    grid->addWidget(foodChart, 0, 1);
+        auto* birthChart = makeLineChart("Birth Count", result.birthCount, QColor(0, 123, 255));
+        grid->addWidget(birthChart, 1, 0);
 
-    auto* birthChart = makeLineChart("Birth Count", result.birthCount, QColor(0, 123, 255));
-    grid->addWidget(birthChart, 1, 0);
+        auto* deathChart = makeLineChart("Death Count", result.deathCount, QColor(255, 99, 132));
+        grid->addWidget(deathChart, 1, 1);
 
-    auto* deathChart = makeLineChart("Death Count", result.deathCount, QColor(255, 99, 132));
-    grid->addWidget(deathChart, 1, 1);
+        buildBinnedSpeciesChart(result, grid);
+    }
+
+    // Mean trait drift per species
+    const int traitCount = result.species.isEmpty() ? 0 : result.species.first().traits.size();
+    for (int trait = 0; trait < traitCount; ++trait) {
+        auto* traitChart = new QChart();
+        traitChart->setTitle(QString("Mean %1").arg(result.species.first().traits[trait].name));
+        auto* traitAxisX = new QValueAxis();
+        traitAxisX->setTitleText("Bin");
+        traitAxisX->setLabelFormat("%d");
+        traitAxisX->setRange(1, std::max(1, static_cast<int>(result.species.first().traits[trait].mean.size())));
+        auto* traitAxisY = new QValueAxis();
+        traitAxisY->setTitleText("Value");
+        traitChart->addAxis(traitAxisX, Qt::AlignBottom);
+        traitChart->addAxis(traitAxisY, Qt::AlignLeft);
+
+        double maxValue = 0.0;
+        for (const auto& seriesData : result.species) {
+            if (trait >= seriesData.traits.size()) {
+                continue;
+            }
+            auto* series = new QLineSeries();
+            series->setName(seriesData.name);
+            const auto& mean = seriesData.traits[trait].mean;
+            for (int i = 0; i < mean.size(); ++i) {
+                series->append(i + 1, mean[i]);
+                maxValue = std::max(maxValue, mean[i]);
+            }
+            series->setColor(seriesData.color);
+            traitChart->addSeries(series);
+            series->attachAxis(traitAxisX);
+            series->attachAxis(traitAxisY);
+        }
+        traitAxisY->setRange(0.0, std::max(1.0, maxValue * 1.1));
+        traitChart->legend()->hide();
+        auto* traitView = new QChartView(traitChart);
+        traitView->setRenderHint(QPainter::Antialiasing);
+        grid->addWidget(traitView, 3 + trait / 2, trait % 2);
+    }
+
+    // Death breakdown pie
+    auto* pieSeries = new QPieSeries();
+    pieSeries->append("Age", result.deathAge);
+    pieSeries->append("Starvation", result.deathHunger);
+    pieSeries->append("Predation", result.deathPredation);
+    auto* pieChart = new QChart();
+    pieChart->addSeries(pieSeries);
+    pieChart->setTitle("Death Breakdown");
+    pieChart->legend()->setAlignment(Qt::AlignTop);
+    auto* pieView = new QChartView(pieChart);
+    pieView->setRenderHint(QPainter::Antialiasing);
+    grid->addWidget(pieView, 2, 1);
+}
 
-    // Species counts
+void ResultsWindow::buildBinnedSpeciesChart(const SimulationResult& result, QGridLayout* grid)
+{
     auto* speciesChart = new QChart();
     speciesChart->setTitle("Species Count");
     auto* axisX = new QValueAxis();
@@ -226,19 +405,6 @@ void ResultsWindow::buildCharts(const SimulationResult& result)
     auto* speciesView = new QChartView(speciesChart);
     speciesView->setRenderHint(QPainter::Antialiasing);
     grid->addWidget(speciesView, 2, 0);
-
-    // Death breakdown pie
-    auto* pieSeries = new QPieSeries();
-    pieSeries->append("Age", result.deathAge);
-    pieSeries->append("Starvation", result.deathHunger);
-    pieSeries->append("Predation", result.deathPredation);
-    auto* pieChart = new QChart();
-    pieChart->addSeries(pieSeries);
-    pieChart->setTitle("Death Breakdown");
-    pieChart->legend()->setAlignment(Qt::AlignTop);
-    auto* pieView = new QChartView(pieChart);
-    pieView->setRenderHint(QPainter::Antialiasing);
-    grid->addWidget(pieView, 2, 1);
 }
 
 void ResultsWindow::applyPlaybackFps(int fps)
@@ -10,6 +10,7 @@ class QAudioOutput;
 class QPushButton;
 class QLabel;
 class QButtonGroup;
+class QGridLayout;
 
 class ResultsWindow : public QWidget {
     Q_OBJECT
@@ -28,6 +29,7 @@ private slots:
 
 private:
     void buildCharts(const SimulationResult& result);
+    void buildBinnedSpeciesChart(const SimulationResult& result, QGridLayout* grid);
     void applyPlaybackFps(int fps);
     void setFpsControlsEnabled(bool enabled);
 
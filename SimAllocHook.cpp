@@ -0,0 +1,45 @@
+// Global operator new hook feeding SimMemory::threadCounters().
+//
+// Link this file into an executable (not into CreatureSimLib) to have
+// MemoryTelemetry count heap allocations. Array, nothrow and sized forms
+// forward to these replacements in the standard library; over-aligned
+// allocations are not counted.
+
+#include "SimMemory.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+const bool s_registered = (SimMemory::markHookInstalled(), true);
+
+}
+
+void* operator new(std::size_t size)
+{
+    AllocationCounters& counters = SimMemory::threadCounters();
+    counters.allocations += 1;
+    counters.bytes += size;
+
+    for (;;) {
+        if (void* p = std::malloc(size ? size : 1)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
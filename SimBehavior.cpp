@@ -2,8 +2,10 @@
 #include "SimRandom.h"
 
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 namespace {
 constexpr double kPi = 3.141592653589793;
@@ -36,12 +38,12 @@ double getDistance(const Creature& creature, const double x, const double y)
  *
  * @param creature Creature selecting food (read-only).
  * @param food Food candidate (read-only).
- * @param tracking Per-tick tracking containing food competition counts (read-only).
+ * @param environment Environment holding food competition counts (read-only).
  * @return Desirability score (higher is better).
  */
 double calculateFoodDesirability(const Creature& creature,
                                  const Food& food,
-                                 const Tracking& tracking)
+                                 const Environment& environment)
 {
     const double distance = std::max(1e-9, getDistance(creature, food.x(), food.y()));
     const double energyValue = food.energyContent();
@@ -52,12 +54,7 @@ double calculateFoodDesirability(const Creature& creature,
             ? 3.0
             : 1.0;
 
-    int competition = 0;
-    if (auto it = tracking.foodCompetitionMap.find(food.id());
-        it != tracking.foodCompetitionMap.end())
-    {
-        competition = it->second;
-    }
+    const int competition = environment.foodCompetition(food);
 
     return ((energyValue * focus) / distance) * (1.0 / (competition + 1));
 }
@@ -72,8 +69,8 @@ double calculateFoodDesirability(const Creature& creature,
  * - is already being focused/targeted by this predator (focus bonus),
  * - has fewer competitors targeting it (competition penalty with soft scaling).
  *
- * Competition is determined by counting how many other creatures in the environment
- * are currently targeting the same prey. The competition penalty uses a fractional
+ * Competition is the number of sensed creatures currently targeting the same
+ * prey, counted by \c perceive(). The competition penalty uses a fractional
  * exponent to reduce desirability without making it drop off too sharply.
  *
  * A small epsilon is used when calculating distance to prevent division by zero
@@ -81,12 +78,12 @@ double calculateFoodDesirability(const Creature& creature,
  *
  * @param creature Predator creature selecting prey (read-only).
  * @param prey Prey candidate (read-only).
- * @param environment Environment containing competitor creatures (read-only).
+ * @param competition Creatures targeting \c prey.
  * @return Desirability score (higher is better).
  */
 double calculatePreyDesirability(const Creature& creature,
                                  const Creature& prey,
-                                 const Environment& environment)
+                                 int competition)
 {
     const double distance = std::max(1e-9, getDistance(creature, prey.x, prey.y));
     const double energyValue = prey.getEnergyContent();
@@ -97,16 +94,6 @@ double calculatePreyDesirability(const Creature& creature,
             ? 1.5
             : 1.0;
 
-    int competition = 0;
-    for (const auto* otherCreature : environment.creatures) {
-        if (otherCreature &&
-            otherCreature->targetFood.type == TargetRef::Type::Creature &&
-            otherCreature->targetFood.creature == &prey)
-        {
-            competition += 1;
-        }
-    }
-
     return ((energyValue * focus) / distance) *
            (1.0 / std::pow(static_cast<double>(competition + 1), 0.2));
 }
@@ -124,13 +111,13 @@ double calculatePreyDesirability(const Creature& creature,
  * @param xDelta Desired X delta to apply.
  * @param yDelta Desired Y delta to apply.
  *
- * @note This function clamps the creature position to [0, envWidth] and
- *       [0, envHeight].
- * @note Movement deltas are doubled when @c creature.state is "fleeing".
+ * @note This function clamps the creature position to the species prototype's
+ *       [0, envWidth] and [0, envHeight].
+ * @note Movement deltas are doubled when @c creature.state is \c CreatureState::Fleeing.
  */
 void move(Creature& creature, double xDelta, double yDelta)
 {
-    if (creature.state == "fleeing") {
+    if (creature.state == CreatureState::Fleeing) {
         xDelta *= 2.0;
         yDelta *= 2.0;
     }
@@ -139,14 +126,12 @@ void move(Creature& creature, double xDelta, double yDelta)
     creature.y += yDelta;
 
     const double movementCost =
-        (std::abs(xDelta) + std::abs(yDelta)) *
-        creature.metabolicBaseRate *
-        creature.metabolicRate;
+        (std::abs(xDelta) + std::abs(yDelta)) * creature.movementCostRate;
 
     creature.fullnessLevel -= movementCost;
 
-    creature.x = std::clamp(creature.x, 0.0, creature.envWidth);
-    creature.y = std::clamp(creature.y, 0.0, creature.envHeight);
+    creature.x = std::clamp<double>(creature.x, 0.0, creature.species->envWidth);
+    creature.y = std::clamp<double>(creature.y, 0.0, creature.species->envHeight);
 }
 
 
@@ -173,10 +158,10 @@ void moveTowards(Creature& creature, double xTarget, double yTarget)
         return;
     }
 
-    const double angle = std::atan2(yDiff, xDiff);
-
-    double xDelta = std::cos(angle) * creature.baseSpeed * creature.speedMultiplier;
-    double yDelta = std::sin(angle) * creature.baseSpeed * creature.speedMultiplier;
+    // Same direction as cos/sin of atan2(yDiff, xDiff), without the trig.
+    const double length = std::sqrt(xDiff * xDiff + yDiff * yDiff);
+    double xDelta = (xDiff / length) * creature.effectiveSpeed;
+    double yDelta = (yDiff / length) * creature.effectiveSpeed;
 
     // Prevent overshooting the target.
     if (std::abs(xDelta) > std::abs(xDiff)) {
@@ -190,149 +175,249 @@ void moveTowards(Creature& creature, double xTarget, double yTarget)
 }
 
 /**
- * @brief Find the closest mate candidate of the same species.
- *
- * Searches the environment for the nearest creature that:
- * - is not the given creature,
- * - is the same species,
- * - is currently eligible to reproduce (reproductionCooldown <= 0).
- *
- * @param creature Creature seeking a mate (read-only).
- * @param environment Environment containing creature candidates (read-only).
- * @return Pointer to the closest valid mate candidate, or nullptr if none found.
+ * @brief Squared distance between a creature and a point.
+ * @param creature Creature to measure from.
+ * @param x Target x coordinate.
+ * @param y Target y coordinate.
+ * @return Squared Euclidean distance.
  */
-Creature* findClosestCreature(const Creature& creature, const Environment& environment)
+double getDistanceSquared(const Creature& creature, const double x, const double y)
 {
-    Creature* closestCreature = nullptr;
-    double minDistance = std::numeric_limits<double>::infinity();
+    const double dx = creature.x - x;
+    const double dy = creature.y - y;
+    return dx * dx + dy * dy;
+}
 
-    for (auto* other : environment.creatures) {
-        if (!other) {
-            continue;
-        }
+/** @brief Behaviour a creature will run unless it ends up fleeing. */
+enum class Intent {
+    Other,
+    Mate,
+    Hunt
+};
 
-        if (other->id != creature.id &&
-            other->speciesName == creature.speciesName &&
-            other->reproductionCooldown <= 0)
-        {
-            const double distance = getDistance(creature, other->x, other->y);
-            if (distance < minDistance) {
-                minDistance = distance;
-                closestCreature = other;
-            }
-        }
+/**
+ * @brief Predict the state \c checkState() picks for a creature that does not flee.
+ * @param creature Creature about to update.
+ * @return Behaviour whose candidates \c perceive() must gather.
+ */
+Intent plannedIntent(const Creature& creature)
+{
+    if (creature.tired) {
+        return Intent::Other;
     }
-
-    return closestCreature;
+    if (creature.fullnessLevel > creature.matingHungerThreshold && creature.reproductionCooldown <= 0) {
+        return Intent::Mate;
+    }
+    if (creature.fullnessLevel < creature.fullnessCap) {
+        return Intent::Hunt;
+    }
+    return Intent::Other;
 }
 
+/** @brief Per-thread lists reused by every gather, so perception allocates nothing once warm. */
+struct GatherBuffers {
+    /** @brief Prey targeted by the sensed creatures, one entry per hunter. */
+    std::vector<const Creature*> targeted;
+    /** @brief Sensed prey candidates in sweep order. */
+    std::vector<Creature*> prey;
+};
+
+thread_local GatherBuffers t_gather;
+
 /**
- * @brief Find the closest predator in the environment.
+ * @brief Gather a creature's neighbourhood; see \c CreatureBehaviour::perceive().
  *
- * Searches the environment for the nearest creature that:
- * - is not the given creature,
- * - is of a different species,
- * - is not a herbivore (i.e. treated as a predator/threat).
+ * Instantiated per \c Diet, so what a species eats and how it weights plants
+ * against prey are resolved at compile time instead of per candidate.
  *
- * If the environment indicates there are no predators (@c environment.hasPredators),
- * the function returns nullptr immediately.
+ * Threats and mates are the closest qualifying creatures, first in sweep order
+ * on ties. Prey and food keep the first candidate with the highest
+ * desirability. Without a sensing radius the sweep covers
+ * \c Environment::visibleCreatures() in order, which reproduces the separate
+ * scans it replaces. With one, only creatures and food within the radius count,
+ * prey competition included.
  *
- * @param creature Creature checking for predators (read-only).
- * @param environment Environment containing other creatures (read-only).
- * @return Pointer to the closest predator creature, or nullptr if none found.
+ * @tparam diet Diet of the creature's species.
+ * @param creature Creature about to update.
+ * @param environment Environment containing creatures, food and food competition counts.
+ * @param intent Behaviour to gather candidates for.
+ * @return Gathered candidates.
  */
-Creature* findClosestPredator(const Creature& creature, const Environment& environment)
+template <Diet diet>
+CreatureBehaviour::Neighborhood gatherAs(const Creature& creature, const Environment& environment, Intent intent)
 {
-    Creature* closestPredator = nullptr;
-    double minDistance = std::numeric_limits<double>::infinity();
-
-    if (!environment.hasPredators) {
-        return nullptr;
-    }
-
-    for (auto* other : environment.creatures) {
-        if (!other) {     
-            continue;
+    constexpr bool eatsPlants = diet != Diet::Carnivore;
+    constexpr bool eatsMeat = diet != Diet::Herbivore;
+    constexpr double plantWeight = diet == Diet::OmnivorePlants ? 2.0 : 1.0;
+    constexpr double meatWeight = diet == Diet::OmnivoreMeat ? 2.0 : 1.0;
+
+    CreatureBehaviour::Neighborhood nearby;
+    const double radius = std::max(0.0, environment.sensingRadius);
+    const bool bounded = radius > 0.0;
+    const double radiusSquared = radius * radius;
+    const bool wantsThreat = environment.hasPredators;
+    const bool wantsMate = intent == Intent::Mate;
+    const bool wantsPrey = eatsMeat && intent == Intent::Hunt;
+
+    if (wantsThreat || wantsMate || wantsPrey) {
+        GatherBuffers& buffers = t_gather;
+        buffers.targeted.clear();
+        buffers.prey.clear();
+        double threatDistance = std::numeric_limits<double>::infinity();
+        double mateDistance = std::numeric_limits<double>::infinity();
+
+        auto sense = [&](Creature* other) {
+            if (!other) {
+                return;
+            }
+            if (bounded && getDistanceSquared(creature, other->x, other->y) > radiusSquared) {
+                return;
+            }
+            if (wantsThreat &&
+                other->id != creature.id &&
+                other->species != creature.species &&
+                other->species->diet != Diet::Herbivore)
+            {
+                const double distance = getDistance(creature, other->x, other->y);
+                if (distance < threatDistance) {
+                    threatDistance = distance;
+                    nearby.threat = other;
+                }
+            }
+            if (wantsMate &&
+                other->id != creature.id &&
+                other->species == creature.species &&
+                other->reproductionCooldown <= 0)
+            {
+                const double distance = getDistance(creature, other->x, other->y);
+                if (distance < mateDistance) {
+                    mateDistance = distance;
+                    nearby.mate = other;
+                }
+            }
+            if (wantsPrey) {
+                if (other->targetFood.type == TargetRef::Type::Creature && other->targetFood.creature) {
+                    buffers.targeted.push_back(other->targetFood.creature);
+                }
+                if (other->species != creature.species && other->health > 0) {
+                    buffers.prey.push_back(other);
+                }
+            }
+        };
+
+        const std::vector<Creature*>& visible = environment.visibleCreatures();
+        if (bounded && &visible == &environment.creatures) {
+            // Chunk lists hold tick-start positions; since then a creature has
+            // moved at most once, by at most twice its speed when fleeing.
+            const ChunkGrid& grid = environment.chunks;
+            const ChunkGrid::Range range =
+                grid.chunksNear(creature.x, creature.y, radius + 2.0 * environment.maxCreatureSpeed);
+            for (int row = range.firstRow; row <= range.lastRow; ++row) {
+                for (int column = range.firstColumn; column <= range.lastColumn; ++column) {
+                    for (auto* other : grid.chunks()[row * grid.columns() + column].creatures) {
+                        sense(other);
+                    }
+                }
+            }
+        } else {
+            for (auto* other : visible) {
+                sense(other);
+            }
         }
 
-        if (other->id == creature.id || other->speciesName == creature.speciesName || other->dietType == "herbivore") {
-            continue;
+        if (wantsPrey && !buffers.prey.empty()) {
+            std::sort(buffers.targeted.begin(), buffers.targeted.end(), std::less<const Creature*>());
+            for (auto* prey : buffers.prey) {
+                const auto hunters = std::equal_range(
+                    buffers.targeted.begin(), buffers.targeted.end(), prey, std::less<const Creature*>());
+                const int competition = static_cast<int>(hunters.second - hunters.first);
+                const double desirability = calculatePreyDesirability(creature, *prey, competition) * meatWeight;
+                if (desirability > nearby.preyScore) {
+                    nearby.preyScore = desirability;
+                    nearby.prey = prey;
+                }
+            }
         }
+    }
 
-        const double distance = getDistance(creature, other->x, other->y);
+    if constexpr (eatsPlants) {
+        if (intent != Intent::Hunt) {
+            return nearby;
+        }
+        auto score = [&](Food* food) {
+            if (food->consumed()) {
+                return;
+            }
+            if (bounded && getDistanceSquared(creature, food->x(), food->y()) > radiusSquared) {
+                return;
+            }
+            const double desirability = calculateFoodDesirability(creature, *food, environment) * plantWeight;
+            if (desirability > nearby.foodScore) {
+                nearby.foodScore = desirability;
+                nearby.food = food;
+            }
+        };
 
-        if (distance < minDistance) {
-            minDistance = distance;
-            closestPredator = other;
+        const std::vector<Food*>& foods = environment.visibleFoods();
+        if (&foods != &environment.foods) {
+            // Strip views hold a subset of the food; score them one by one.
+            for (auto* food : foods) {
+                score(food);
+            }
+        } else if (bounded) {
+            const ChunkGrid& grid = environment.chunks;
+            const ChunkGrid::Range range = grid.chunksNear(creature.x, creature.y, radius);
+            for (int row = range.firstRow; row <= range.lastRow; ++row) {
+                for (int column = range.firstColumn; column <= range.lastColumn; ++column) {
+                    for (auto* food : grid.chunks()[row * grid.columns() + column].foods) {
+                        score(food);
+                    }
+                }
+            }
+        } else {
+            // A consumed target is dropped by goHunt() before it moves, so it earns no focus.
+            const Food* target = creature.targetFood.type == TargetRef::Type::Food ? creature.targetFood.food : nullptr;
+            const int focusIndex = target && !target->consumed() ? target->storageIndex() : -1;
+            const FoodPick pick =
+                bestFoodCandidate(environment.foodCandidates(), creature.x, creature.y, focusIndex, plantWeight);
+            if (pick.index >= 0) {
+                nearby.foodScore = pick.score;
+                nearby.food = foods[pick.index];
+            }
         }
     }
 
-    return closestPredator;
+    return nearby;
 }
 
 /**
- * @brief Select the best food or prey target.
- * @param creature Creature selecting targets.
- * @param environment Environment containing food and prey.
- * @param tracking Per-tick tracking with competition data.
+ * @brief Select the best food or prey target from a creature's neighbourhood.
+ *
+ * Prey is picked over food only when it scores strictly higher.
+ *
+ * @param creature Creature selecting targets; a consumed food target is cleared.
+ * @param nearby Candidates from \c perceive().
  * @return Target reference describing the best option.
  */
-TargetRef findBestFood(Creature& creature, Environment& environment, Tracking& tracking)
+TargetRef findBestFood(Creature& creature, const CreatureBehaviour::Neighborhood& nearby)
 {
-    TargetRef best;
-    double highestDesirability = -std::numeric_limits<double>::infinity();
-
-    if (creature.targetFood.type == TargetRef::Type::Food) {
-        bool exists = false;
-        for (auto* food : environment.foods) {
-            if (food->consumed()) {
-                continue;
-            }
-            if (creature.targetFood.food == food) {
-                exists = true;
-                break;
-            }
-        }
-        if (!exists) {
-            creature.targetFood = TargetRef();
-        }
+    // Targets of removed food are cleared by Environment, so the pointer is live.
+    if (creature.targetFood.type == TargetRef::Type::Food &&
+        (!creature.targetFood.food || creature.targetFood.food->consumed()))
+    {
+        creature.targetFood = TargetRef();
     }
 
-    if (creature.dietType == "herbivore" || creature.dietType == "omnivore") {
-        for (auto* food : environment.foods) {
-            if (food->consumed()) {
-                continue;
-            }
-            double desirability = calculateFoodDesirability(creature, *food, tracking);
-            if (creature.dietType == "omnivore" && creature.dietPreference == "Plants") {
-                desirability *= 2.0;
-            }
-            if (desirability > highestDesirability) {
-                highestDesirability = desirability;
-                best.type = TargetRef::Type::Food;
-                best.food = food;
-                best.creature = nullptr;
-            }
-        }
+    TargetRef best;
+    if (nearby.food) {
+        best.type = TargetRef::Type::Food;
+        best.food = nearby.food;
     }
-
-    if (creature.dietType == "carnivore" || creature.dietType == "omnivore") {
-        for (auto* potentialPrey : environment.creatures) {
-            if (potentialPrey->speciesName != creature.speciesName && potentialPrey->health > 0) {
-                double desirability = calculatePreyDesirability(creature, *potentialPrey, environment);
-                if (creature.dietType == "omnivore" && creature.dietPreference == "Meat") {
-                    desirability *= 2.0;
-                }
-                if (desirability > highestDesirability) {
-                    highestDesirability = desirability;
-                    best.type = TargetRef::Type::Creature;
-                    best.creature = potentialPrey;
-                    best.food = nullptr;
-                }
-            }
-        }
+    if (nearby.prey && nearby.preyScore > nearby.foodScore) {
+        best.type = TargetRef::Type::Creature;
+        best.creature = nearby.prey;
+        best.food = nullptr;
     }
-
     return best;
 }
 
@@ -345,12 +430,7 @@ TargetRef findBestFood(Creature& creature, Environment& environment, Tracking& t
 void consumeFood(Creature& creature, Food& food, Environment& environment)
 {
     creature.fullnessLevel += food.energyContent();
-    for (auto it = environment.foods.begin(); it != environment.foods.end(); ++it) {
-        if (*it == &food) {
-            food.markConsumed();
-            break;
-        }
-    }
+    environment.consumeFood(food);
     creature.targetFood = TargetRef();
     creature.tired = true;
     creature.recoveryNeeded = 2;
@@ -397,7 +477,7 @@ double mutateValuePercent(double value, double mutationFactor, double factor)
  */
 int mutateBirth(const Creature& creature, const Creature& otherCreature)
 {
-    if (SimRandom::urand() < creature.mutationFactor && SimRandom::urand() < otherCreature.mutationFactor) {
+    if (SimRandom::urand() < creature.species->mutationFactor && SimRandom::urand() < otherCreature.species->mutationFactor) {
         double newLitter = std::round((creature.litterSize + otherCreature.litterSize) / 2.0 + SimRandom::urand() * 2 - 1);
         if (newLitter < 1) {
             return 1;
@@ -408,12 +488,16 @@ int mutateBirth(const Creature& creature, const Creature& otherCreature)
 }
 
 /**
- * @brief Produce a mutated child configuration for reproduction.
+ * @brief Write mutated heritable traits into a newborn.
+ *
+ * Species-wide data (name, colour, diet, age rate, mutation factor, bounds) is
+ * shared through the prototype and is not copied.
+ *
  * @param creature First parent.
  * @param otherCreature Second parent.
- * @return Child configuration with mutations applied.
+ * @param child Newborn of the parents' species (mutated).
  */
-CreatureSettings reproduce(const Creature& creature, const Creature& otherCreature)
+void reproduce(const Creature& creature, const Creature& otherCreature, Creature& child)
 {
     struct Factors {
         double baseSpeed = 0.1;
@@ -435,89 +519,59 @@ CreatureSettings reproduce(const Creature& creature, const Creature& otherCreatu
         double fleeRecoveryFactor = 0.1;
     } factors;
 
-    CreatureSettings config;
-    config.speciesName = creature.speciesName;
-    config.baseSpeed = (mutateValuePercent(creature.baseSpeed, creature.mutationFactor, factors.baseSpeed)
-        + mutateValuePercent(otherCreature.baseSpeed, otherCreature.mutationFactor, factors.baseSpeed)) / 2.0;
-    config.speedMultiplier = (mutateValuePercent(creature.speedMultiplier, creature.mutationFactor, factors.speedMultiplier)
-        + mutateValuePercent(otherCreature.speedMultiplier, otherCreature.mutationFactor, factors.speedMultiplier)) / 2.0;
-    config.health = static_cast<int>((mutateValuePercent(creature.health, creature.mutationFactor, factors.health)
-        + mutateValuePercent(otherCreature.health, otherCreature.mutationFactor, factors.health)) / 2.0);
-    config.age = 0;
-    config.ageCap = (mutateValuePercent(creature.ageCap, creature.mutationFactor, factors.ageCap)
-        + mutateValuePercent(otherCreature.ageCap, otherCreature.mutationFactor, factors.ageCap)) / 2.0;
-    config.ageRate = creature.ageRate;
-    config.fullnessCap = static_cast<int>((mutateValuePercent(creature.fullnessCap, creature.mutationFactor, factors.fullnessCap)
-        + mutateValuePercent(otherCreature.fullnessCap, otherCreature.mutationFactor, factors.fullnessCap)) / 2.0);
-    config.initialFullness = static_cast<int>(std::floor(
-        (mutateValuePercent(creature.fullnessCap / 2.0, creature.mutationFactor, factors.fullnessCap)
-            + mutateValuePercent(otherCreature.fullnessCap / 2.0, otherCreature.mutationFactor, factors.fullnessCap)) / 2.0));
+    const double mutationFactor = creature.species->mutationFactor;
+    const double otherMutationFactor = otherCreature.species->mutationFactor;
+
+    child.baseSpeed = (mutateValuePercent(creature.baseSpeed, mutationFactor, factors.baseSpeed)
+        + mutateValuePercent(otherCreature.baseSpeed, otherMutationFactor, factors.baseSpeed)) / 2.0;
+    child.speedMultiplier = (mutateValuePercent(creature.speedMultiplier, mutationFactor, factors.speedMultiplier)
+        + mutateValuePercent(otherCreature.speedMultiplier, otherMutationFactor, factors.speedMultiplier)) / 2.0;
+    child.health = static_cast<int>((mutateValuePercent(creature.health, mutationFactor, factors.health)
+        + mutateValuePercent(otherCreature.health, otherMutationFactor, factors.health)) / 2.0);
+    child.age = 0.0;
+    child.ageCap = static_cast<int>((mutateValuePercent(creature.ageCap, mutationFactor, factors.ageCap)
+        + mutateValuePercent(otherCreature.ageCap, otherMutationFactor, factors.ageCap)) / 2.0);
+    child.fullnessCap = static_cast<int>((mutateValuePercent(creature.fullnessCap, mutationFactor, factors.fullnessCap)
+        + mutateValuePercent(otherCreature.fullnessCap, otherMutationFactor, factors.fullnessCap)) / 2.0);
+    child.fullnessLevel = static_cast<int>(std::floor(
+        (mutateValuePercent(creature.fullnessCap / 2.0, mutationFactor, factors.fullnessCap)
+            + mutateValuePercent(otherCreature.fullnessCap / 2.0, otherMutationFactor, factors.fullnessCap)) / 2.0));
     
-    config.metabolicBaseRate = (mutateValuePercent(creature.metabolicBaseRate, creature.mutationFactor, factors.metabolicBaseRate)
-        + mutateValuePercent(otherCreature.metabolicBaseRate, otherCreature.mutationFactor, factors.metabolicBaseRate)) / 2.0;
-    config.metabolicRate = (mutateValuePercent(creature.metabolicRate, creature.mutationFactor, factors.metabolicRate)
-        + mutateValuePercent(otherCreature.metabolicRate, otherCreature.mutationFactor, factors.metabolicRate)) / 2.0;
+    child.metabolicBaseRate = (mutateValuePercent(creature.metabolicBaseRate, mutationFactor, factors.metabolicBaseRate)
+        + mutateValuePercent(otherCreature.metabolicBaseRate, otherMutationFactor, factors.metabolicBaseRate)) / 2.0;
+    child.metabolicRate = (mutateValuePercent(creature.metabolicRate, mutationFactor, factors.metabolicRate)
+        + mutateValuePercent(otherCreature.metabolicRate, otherMutationFactor, factors.metabolicRate)) / 2.0;
     
-    config.energyStorageRate = (mutateValuePercent(creature.energyStorageRate, creature.mutationFactor, factors.energyStorageRate)
-        + mutateValuePercent(otherCreature.energyStorageRate, otherCreature.mutationFactor, factors.energyStorageRate)) / 2.0;
-    config.reserveEnergy = 0.0;
-    config.dietType = creature.dietType == otherCreature.dietType ? creature.dietType : "omnivore";
-    config.dietPreference = (SimRandom::urand() > 0.5) ? creature.dietPreference : otherCreature.dietPreference;
-    config.reproductionCost = static_cast<int>((mutateValuePercent(creature.reproductionCost, creature.mutationFactor, factors.reproductionCost)
-        + mutateValuePercent(otherCreature.reproductionCost, otherCreature.mutationFactor, factors.reproductionCost)) / 2.0);
-    config.matingHungerThreshold = static_cast<int>((mutateValuePercent(creature.matingHungerThreshold, creature.mutationFactor, factors.matingHungerThreshold)
-        + mutateValuePercent(otherCreature.matingHungerThreshold, otherCreature.mutationFactor, factors.matingHungerThreshold)) / 2.0);
-    config.reproductionCooldown = static_cast<int>((mutateValuePercent(creature.reproductionCooldownCap, creature.mutationFactor, factors.reproductionCooldown)
-        + mutateValuePercent(otherCreature.reproductionCooldownCap, otherCreature.mutationFactor, factors.reproductionCooldown)) / 2.0);
-    config.litterSize = mutateBirth(creature, otherCreature);
-    config.colorR = creature.colorR;
-    config.colorG = creature.colorG;
-    config.colorB = creature.colorB;
-    config.size = creature.size;
-    config.mutationFactor = creature.mutationFactor;
-    config.attackPower = (mutateValuePercent(creature.attackPower, creature.mutationFactor, factors.attackPower)
-        + mutateValuePercent(otherCreature.attackPower, otherCreature.mutationFactor, factors.attackPower)) / 2.0;
-    config.defencePower = (mutateValuePercent(creature.defencePower, creature.mutationFactor, factors.defencePower)
-        + mutateValuePercent(otherCreature.defencePower, otherCreature.mutationFactor, factors.defencePower)) / 2.0;
-    config.skittishMultiplierBase = (mutateValuePercent(creature.skittishMultiplierBase, creature.mutationFactor, factors.skittishMultiplierBase)
-        + mutateValuePercent(otherCreature.skittishMultiplierBase, otherCreature.mutationFactor, factors.skittishMultiplierBase)) / 2.0;
-    config.skittishMultiplierScared = (mutateValuePercent(creature.skittishMultiplierScared, creature.mutationFactor, factors.skittishMultiplierScared)
-        + mutateValuePercent(otherCreature.skittishMultiplierScared, otherCreature.mutationFactor, factors.skittishMultiplierScared)) / 2.0;
-    config.fleeExhaustion = (mutateValuePercent(creature.fleeExhaustionRate, creature.mutationFactor, factors.fleeExhaustionRate)
-        + mutateValuePercent(otherCreature.fleeExhaustionRate, otherCreature.mutationFactor, factors.fleeExhaustionRate)) / 2.0;
-    config.fleeRecoveryFactor = (mutateValuePercent(creature.fleeRecoveryFactor, creature.mutationFactor, factors.fleeRecoveryFactor)
-        + mutateValuePercent(otherCreature.fleeRecoveryFactor, otherCreature.mutationFactor, factors.fleeRecoveryFactor)) / 2.0;
-
-    return config;
-}
-
-/**
- * @brief Update food competition counts for targeting changes.
- * @param tracking Per-tick tracking accumulator.
- * @param oldFoodID Previous food id (or -1).
- * @param newFoodID New food id (or -1).
- */
-void updateFoodCompetitionMap(Tracking& tracking, int oldFoodID, int newFoodID)
-{
-    if (oldFoodID != -1) {
-        auto it = tracking.foodCompetitionMap.find(oldFoodID);
-        if (it != tracking.foodCompetitionMap.end()) {
-            if (it->second > 1) {
-                it->second -= 1;
-            } else {
-                tracking.foodCompetitionMap.erase(it);
-            }
-        }
-    }
-
-    if (newFoodID != -1) {
-        auto it = tracking.foodCompetitionMap.find(newFoodID);
-        if (it != tracking.foodCompetitionMap.end()) {
-            it->second += 1;
-        } else {
-            tracking.foodCompetitionMap.emplace(newFoodID, 1);
-        }
-    }
+    child.energyStorageRate = (mutateValuePercent(creature.energyStorageRate, mutationFactor, factors.energyStorageRate)
+        + mutateValuePercent(otherCreature.energyStorageRate, otherMutationFactor, factors.energyStorageRate)) / 2.0;
+    child.reserveEnergy = 0.0;
+    // Diet is species-wide now, but the parent whose diet preference the child
+    // inherited used to be drawn here; keep the draw so seeded runs replay.
+    static_cast<void>(SimRandom::urand());
+    child.reproductionCost = static_cast<int>((mutateValuePercent(creature.reproductionCost, mutationFactor, factors.reproductionCost)
+        + mutateValuePercent(otherCreature.reproductionCost, otherMutationFactor, factors.reproductionCost)) / 2.0);
+    child.matingHungerThreshold = static_cast<int>((mutateValuePercent(creature.matingHungerThreshold, mutationFactor, factors.matingHungerThreshold)
+        + mutateValuePercent(otherCreature.matingHungerThreshold, otherMutationFactor, factors.matingHungerThreshold)) / 2.0);
+    child.reproductionCooldown = static_cast<int>((mutateValuePercent(creature.reproductionCooldownCap, mutationFactor, factors.reproductionCooldown)
+        + mutateValuePercent(otherCreature.reproductionCooldownCap, otherMutationFactor, factors.reproductionCooldown)) / 2.0);
+    child.reproductionCooldownCap = child.reproductionCooldown;
+    child.litterSize = mutateBirth(creature, otherCreature);
+    child.size = creature.size;
+    child.attackPower = (mutateValuePercent(creature.attackPower, mutationFactor, factors.attackPower)
+        + mutateValuePercent(otherCreature.attackPower, otherMutationFactor, factors.attackPower)) / 2.0;
+    child.defencePower = (mutateValuePercent(creature.defencePower, mutationFactor, factors.defencePower)
+        + mutateValuePercent(otherCreature.defencePower, otherMutationFactor, factors.defencePower)) / 2.0;
+    child.skittishMultiplierBase = (mutateValuePercent(creature.skittishMultiplierBase, mutationFactor, factors.skittishMultiplierBase)
+        + mutateValuePercent(otherCreature.skittishMultiplierBase, otherMutationFactor, factors.skittishMultiplierBase)) / 2.0;
+    child.skittishMultiplier = child.skittishMultiplierBase;
+    child.skittishMultiplierScared = (mutateValuePercent(creature.skittishMultiplierScared, mutationFactor, factors.skittishMultiplierScared)
+        + mutateValuePercent(otherCreature.skittishMultiplierScared, otherMutationFactor, factors.skittishMultiplierScared)) / 2.0;
+    child.fleeExhaustionRate = (mutateValuePercent(creature.fleeExhaustionRate, mutationFactor, factors.fleeExhaustionRate)
+        + mutateValuePercent(otherCreature.fleeExhaustionRate, otherMutationFactor, factors.fleeExhaustionRate)) / 2.0;
+    child.fleeRecoveryFactor = (mutateValuePercent(creature.fleeRecoveryFactor, mutationFactor, factors.fleeRecoveryFactor)
+        + mutateValuePercent(otherCreature.fleeRecoveryFactor, otherMutationFactor, factors.fleeRecoveryFactor)) / 2.0;
+
+    child.updateDerived();
 }
 
 /**
@@ -532,7 +586,7 @@ void attackPrey(Creature& creature, Creature& prey, Tracking& tracking)
     if (prey.health <= 0) {
         const QString cause = "predation";
         tracking.deathCause.predation = tracking.deathCause.predation + 1;
-        tracking.deaths.push_back(prey.speciesName);
+        tracking.deaths.push_back(prey.species->index);
         tracking.preyToAdd.push_back(prey.id);
         consumePrey(creature, prey);
     }
@@ -542,7 +596,7 @@ void attackPrey(Creature& creature, Creature& prey, Tracking& tracking)
 namespace CreatureBehaviour {
 void updateAge(Creature& creature)
 {
-    creature.age += creature.ageRate;
+    creature.age += creature.species->ageRate;
 }
 
 void updateCooldowns(Creature& creature)
@@ -592,79 +646,109 @@ void checkSurvival(Creature& creature)
     checkHealth(creature);
 }
 
-void checkSafety(Creature& creature, Environment& environment)
+Neighborhood perceive(const Creature& creature, const Environment& environment)
 {
-    if (creature.state == "fleeing") {
+    const Intent intent = plannedIntent(creature);
+    switch (creature.species->diet) {
+    case Diet::Herbivore:
+        return gatherAs<Diet::Herbivore>(creature, environment, intent);
+    case Diet::Carnivore:
+        return gatherAs<Diet::Carnivore>(creature, environment, intent);
+    case Diet::Omnivore:
+        return gatherAs<Diet::Omnivore>(creature, environment, intent);
+    case Diet::OmnivorePlants:
+        return gatherAs<Diet::OmnivorePlants>(creature, environment, intent);
+    case Diet::OmnivoreMeat:
+        return gatherAs<Diet::OmnivoreMeat>(creature, environment, intent);
+    }
+    return Neighborhood();
+}
+
+void checkSafety(Creature& creature, const Neighborhood& nearby)
+{
+    if (creature.state == CreatureState::Fleeing) {
         creature.skittishMultiplier = creature.skittishMultiplierScared;
     } else {
         creature.skittishMultiplier = creature.skittishMultiplierBase;
     }
 
-    Creature* closestPredator = findClosestPredator(creature, environment);
+    Creature* closestPredator = nearby.threat;
+    creature.threatDistance = closestPredator
+        ? creature.getDistance(closestPredator->x, closestPredator->y)
+        : std::numeric_limits<double>::infinity();
     if (closestPredator) {
-        if (creature.getDistance(closestPredator->x, closestPredator->y) <=
-            creature.baseSpeed * creature.speedMultiplier * creature.skittishMultiplier) {
-            creature.state = "fleeing";
+        if (creature.threatDistance <=
+            creature.effectiveSpeed * creature.skittishMultiplier) {
+            creature.state = CreatureState::Fleeing;
             creature.predator = closestPredator;
             return;
         }
-        creature.state = "";
+        creature.state = CreatureState::None;
         creature.predator = nullptr;
         return;
     }
 
-    if (creature.state == "fleeing") {
-        creature.state = "";
+    if (creature.state == CreatureState::Fleeing) {
+        creature.state = CreatureState::None;
         creature.predator = nullptr;
     }
 }
 
+static void recoverFromFleeing(Creature& creature)
+{
+    if (creature.fleeRecoverycooldown > 0) {
+        creature.fleeRecoverycooldown = creature.fleeRecoverycooldown - 1;
+    } else if (creature.fleeRecoverycooldown <= 0 && creature.fleeCount > 0) {
+        creature.fleeCount = creature.fleeCount - 1;
+    }
+}
+
 void checkState(Creature& creature)
 {
-    if (creature.state == "fleeing") {
+    if (creature.state == CreatureState::Fleeing) {
         creature.fleeCount = creature.fleeCount + 1;
         creature.fleeRecoverycooldown = creature.fleeRecoverycooldown + 1;
         return;
     }
 
-    if (creature.fleeRecoverycooldown > 0) {
-        creature.fleeRecoverycooldown = creature.fleeRecoverycooldown - 1;
-    } else if (creature.fleeRecoverycooldown <= 0 && creature.fleeCount > 0) {
-        creature.fleeCount = creature.fleeCount - 1;
-    }
+    recoverFromFleeing(creature);
 
     if (creature.tired) {
-        creature.state = "resting";
+        creature.state = CreatureState::Resting;
         return;
     }
 
     if (creature.fullnessLevel > creature.matingHungerThreshold && creature.reproductionCooldown <= 0) {
-        creature.state = "mating";
+        creature.state = CreatureState::Mating;
         return;
     }
 
     if (creature.fullnessLevel < creature.fullnessCap) {
-        creature.state = "hunting";
+        creature.state = CreatureState::Hunting;
         return;
     }
 
-    creature.state = "exploring";
+    creature.state = CreatureState::Exploring;
 }
 
-void goMate(Creature& creature, Environment& environment, Tracking& tracking)
+void goMate(Creature& creature, const Neighborhood& nearby, Environment& environment, Tracking& tracking)
 {
-    Creature* closestCreature = findClosestCreature(creature, environment);
+    Creature* closestCreature = nearby.mate;
     if (closestCreature) {
         moveTowards(creature, closestCreature->x, closestCreature->y);
         if (creature.getDistance(closestCreature->x, closestCreature->y) <= creature.size + creature.size / 2.0) {
             creature.fullnessLevel -= creature.reproductionCost;
             closestCreature->fullnessLevel -= closestCreature->reproductionCost;
 
+            // Parents pay for the attempt even when the budget refuses some of the litter.
             for (int i = 0; i < creature.litterSize; i++) {
-                CreatureSettings babyConfig = reproduce(creature, *closestCreature);
-                Creature* baby = creature.makeBaby(babyConfig, environment.creatureID++, creature.x, closestCreature->y);
+                if (!environment.reserveBirth()) {
+                    continue;
+                }
+                Creature* baby = creature.makeBaby(environment.newCreatureId(), creature.x, closestCreature->y);
+                reproduce(creature, *closestCreature, *baby);
                 tracking.newborns.push_back(baby);
-                tracking.births.push_back(creature.speciesName);
+                tracking.births.push_back(creature.species->index);
             }
 
             creature.reproductionCooldown = creature.reproductionCooldownCap;
@@ -677,12 +761,12 @@ void goMate(Creature& creature, Environment& environment, Tracking& tracking)
     goExplore(creature);
 }
 
-void goHunt(Creature& creature, Environment& environment, Tracking& tracking)
+void goHunt(Creature& creature, const Neighborhood& nearby, Environment& environment, Tracking& tracking)
 {
-    int targetID = creature.targetFood.type != TargetRef::Type::None ? creature.targetFood.id() : -1;
-    TargetRef bestFood = findBestFood(creature, environment, tracking);
+    const Food* previousFood = creature.targetFood.type == TargetRef::Type::Food ? creature.targetFood.food : nullptr;
+    TargetRef bestFood = findBestFood(creature, nearby);
     if (bestFood.type != TargetRef::Type::None) {
-        updateFoodCompetitionMap(tracking, targetID, bestFood.id());
+        environment.retargetFood(previousFood, bestFood.type == TargetRef::Type::Food ? bestFood.food : nullptr);
         creature.targetFood = bestFood;
         moveTowards(creature, bestFood.x(), bestFood.y());
         double targetSize = 0.0;
@@ -699,20 +783,21 @@ void goHunt(Creature& creature, Environment& environment, Tracking& tracking)
             }
         }
     } else {
-        const double angle = SimRandom::urand() * 2.0 * kPi;
-        const double xDelta = std::cos(angle) * creature.baseSpeed * creature.speedMultiplier;
-        const double yDelta = std::sin(angle) * creature.baseSpeed * creature.speedMultiplier;
-        move(creature, xDelta, yDelta);
+        const Heading heading = SimMath::unitVector(SimRandom::urand() * 2.0 * kPi);
+        move(creature, heading.x * creature.effectiveSpeed, heading.y * creature.effectiveSpeed);
     }
 }
 
 void goFlee(Creature& creature)
 {
-    if (!creature.predator) { creature.state = ""; return; }
-
-    const double angle = std::atan2(creature.y - creature.predator->y, creature.x - creature.predator->x);
-    const double xDelta = std::cos(angle) * creature.baseSpeed * creature.speedMultiplier;
-    const double yDelta = std::sin(angle) * creature.baseSpeed * creature.speedMultiplier;
+    if (!creature.predator) { creature.state = CreatureState::None; return; }
+
+    const double xAway = creature.x - creature.predator->x;
+    const double yAway = creature.y - creature.predator->y;
+    const double length = std::sqrt(xAway * xAway + yAway * yAway);
+    // atan2(0, 0) is 0, so a predator on top of the creature sends it along +x.
+    const double xDelta = length > 0.0 ? (xAway / length) * creature.effectiveSpeed : creature.effectiveSpeed;
+    const double yDelta = length > 0.0 ? (yAway / length) * creature.effectiveSpeed : 0.0;
     move(creature, xDelta, yDelta);
 }
 
@@ -722,7 +807,7 @@ void goRest(Creature& creature)
     if (creature.recoveryNeeded <= 0) {
         creature.tired = false;
         creature.recoveryNeeded = 0;
-        creature.state = "exploring";
+        creature.state = CreatureState::Exploring;
     }
 }
 
@@ -731,19 +816,50 @@ void goExplore(Creature& creature)
     const double maxTurnAngle = (18.0 * kPi) / 180.0;
     if (creature.hasLastDirection) {
         const double angleChange = SimRandom::urand() * 2 * maxTurnAngle - maxTurnAngle;
-        const double angle = creature.lastDirection + angleChange;
-        creature.lastDirection = angle;
-        const double xDelta = std::cos(angle) * creature.baseSpeed * creature.speedMultiplier;
-        const double yDelta = std::sin(angle) * creature.baseSpeed * creature.speedMultiplier;
-        move(creature, xDelta, yDelta);
+        creature.lastDirection = SimMath::rotate(creature.lastDirection, angleChange);
     } else {
-        const double angle = SimRandom::urand() * 2 * kPi;
-        creature.lastDirection = angle;
+        creature.lastDirection = SimMath::unitVector(SimRandom::urand() * 2 * kPi);
         creature.hasLastDirection = true;
-        const double xDelta = std::cos(angle) * creature.baseSpeed * creature.speedMultiplier;
-        const double yDelta = std::sin(angle) * creature.baseSpeed * creature.speedMultiplier;
-        move(creature, xDelta, yDelta);
     }
+    move(creature,
+        creature.lastDirection.x * creature.effectiveSpeed,
+        creature.lastDirection.y * creature.effectiveSpeed);
 }
+
+int updateInterval(const Creature& creature, const Environment& environment)
+{
+    const int interval = environment.lodInterval;
+    // Exploring never lasts: the first metabolic cost drops fullness below the cap
+    // and the creature turns to hunting, so only long rests are worth skipping.
+    if (interval <= 1 || creature.dead || creature.state != CreatureState::Resting || creature.recoveryNeeded <= interval) {
+        return 1;
+    }
+
+    // Worst case both sides close in at full (fleeing) speed for the whole interval.
+    // A predator may wait unsensed just beyond the sensing bound.
+    const double fleeRadius = creature.effectiveSpeed * creature.skittishMultiplierScared;
+    const double closing = 2.0 * (environment.maxCreatureSpeed + creature.effectiveSpeed) * interval;
+    const double threatDistance = environment.hasPredators
+        ? std::min(creature.threatDistance, environment.sensingBound())
+        : creature.threatDistance;
+    if (threatDistance <= fleeRadius + closing) {
+        return 1;
+    }
+    return interval;
 }
 
+void integrateIdle(Creature& creature, int ticks)
+{
+    for (int i = 0; i < ticks; i++) {
+        updateAge(creature);
+        updateCooldowns(creature);
+        checkSurvival(creature);
+        if (creature.dead) {
+            return;
+        }
+
+        recoverFromFleeing(creature);
+        goRest(creature);
+    }
+}
+}
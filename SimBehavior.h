@@ -3,8 +3,44 @@
 #include "SimCreature.h"
 #include "SimEnvironment.h"
 
+#include <limits>
+
 /** @brief Creature behavior utilities used by the simulation. */
 namespace CreatureBehaviour {
+/**
+ * @brief What a creature senses at the start of its update, see \c perceive().
+ */
+struct Neighborhood {
+    /** @brief Closest creature of another, non-herbivore species, or nullptr. */
+    Creature* threat = nullptr;
+    /** @brief Closest same-species creature ready to mate; only gathered for creatures about to mate. */
+    Creature* mate = nullptr;
+    /** @brief Most desirable food; only gathered for creatures about to hunt. */
+    Food* food = nullptr;
+    /** @brief Diet-weighted desirability of \c food. */
+    double foodScore = -std::numeric_limits<double>::infinity();
+    /** @brief Most desirable prey; only gathered for creatures about to hunt. */
+    Creature* prey = nullptr;
+    /** @brief Diet-weighted desirability of \c prey. */
+    double preyScore = -std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Gather the threat, mate, food and prey candidates in one pass.
+ *
+ * A single sweep over the sensed creatures finds the closest threat and, for the
+ * state \c checkState() will pick unless the creature flees, either the closest
+ * mate or the best prey, counting competition for prey in the same sweep. Food is
+ * scored in a second sweep over the sensed food only when the creature hunts.
+ * Dispatches once on \c SpeciesPrototype::diet to a kernel compiled for that diet.
+ *
+ * @param creature Creature about to update.
+ * @param environment Environment providing \c sensingRadius, creatures and food.
+ * @return Candidates for \c checkSafety(), \c goMate() and \c goHunt().
+ * @note No other creature acts between this call and the creature's behaviours,
+ *       so without a sensing radius the picks equal those of separate full scans.
+ */
+Neighborhood perceive(const Creature& creature, const Environment& environment);
 /**
  * @brief Increment creature age by its configured rate.
  * @param creature Creature to update.
@@ -23,9 +59,9 @@ void checkSurvival(Creature& creature);
 /**
  * @brief Update fleeing state based on nearby predators.
  * @param creature Creature to update.
- * @param environment Environment containing predators.
+ * @param nearby Candidates from \c perceive().
  */
-void checkSafety(Creature& creature, Environment& environment);
+void checkSafety(Creature& creature, const Neighborhood& nearby);
 /**
  * @brief Decide creature state (hunting, mating, resting, exploring).
  * @param creature Creature to update.
@@ -34,18 +70,21 @@ void checkState(Creature& creature);
 /**
  * @brief Move toward mate and reproduce when in range.
  * @param creature Creature to update.
- * @param environment Environment containing mates.
+ * @param nearby Candidates from \c perceive().
+ * @param environment Environment handing out newborn ids and birth room.
  * @param tracking Per-tick tracking accumulator.
  * @note Newly spawned creatures are stored in \c tracking.newborns.
+ * @note Each newborn is claimed with \c Environment::reserveBirth() before it is allocated.
  */
-void goMate(Creature& creature, Environment& environment, Tracking& tracking);
+void goMate(Creature& creature, const Neighborhood& nearby, Environment& environment, Tracking& tracking);
 /**
  * @brief Seek food or prey and consume when close enough.
  * @param creature Creature to update.
- * @param environment Environment containing food and prey.
+ * @param nearby Candidates from \c perceive(); prey wins only when it scores higher than food.
+ * @param environment Environment tracking food claims.
  * @param tracking Per-tick tracking accumulator.
  */
-void goHunt(Creature& creature, Environment& environment, Tracking& tracking);
+void goHunt(Creature& creature, const Neighborhood& nearby, Environment& environment, Tracking& tracking);
 /**
  * @brief Flee directly away from the current predator.
  * @param creature Creature to update.
@@ -61,4 +100,28 @@ void goRest(Creature& creature);
  * @param creature Creature to update.
  */
 void goExplore(Creature& creature);
+/**
+ * @brief Pick how often an idle creature needs a full update.
+ *
+ * Resting creatures with more recovery left than the interval are put in the
+ * idle tier when no predator could reach their flee radius within it; everything
+ * else is updated every tick. When no threat was sensed, one is assumed to wait
+ * just beyond \c Environment::sensingBound().
+ *
+ * @param creature Creature that just ran a full update.
+ * @param environment Environment providing \c lodInterval and the speed bound.
+ * @return Ticks until the next full update (1 = every tick).
+ */
+int updateInterval(const Creature& creature, const Environment& environment);
+/**
+ * @brief Catch up on ticks skipped while in the idle tier.
+ *
+ * Replays the cheap per-tick work for each skipped tick (ageing, cooldowns,
+ * hunger and survival checks, flee recovery and resting) without perception or
+ * decision making.
+ *
+ * @param creature Creature to update.
+ * @param ticks Number of skipped ticks.
+ */
+void integrateIdle(Creature& creature, int ticks);
 }
@@ -0,0 +1,119 @@
+#include "SimChunks.h"
+#include "SimCreature.h"
+#include "SimFood.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ChunkGrid::reset(double worldWidth, double worldHeight, int chunkSize)
+{
+    m_chunkSize = std::max(1, chunkSize);
+    m_columns = std::max(1, static_cast<int>(std::ceil(worldWidth / m_chunkSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(worldHeight / m_chunkSize)));
+    m_chunks.assign(static_cast<size_t>(m_columns) * m_rows, Chunk());
+    m_dirty.clear();
+}
+
+int ChunkGrid::chunkIndex(double x, double y) const
+{
+    const int column = std::clamp(static_cast<int>(x / m_chunkSize), 0, m_columns - 1);
+    const int row = std::clamp(static_cast<int>(y / m_chunkSize), 0, m_rows - 1);
+    return row * m_columns + column;
+}
+
+static std::uint64_t spreadBits(std::uint32_t value)
+{
+    std::uint64_t bits = value;
+    bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFull;
+    bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFull;
+    bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    bits = (bits | (bits << 2)) & 0x3333333333333333ull;
+    bits = (bits | (bits << 1)) & 0x5555555555555555ull;
+    return bits;
+}
+
+std::uint64_t ChunkGrid::mortonKey(double x, double y) const
+{
+    constexpr int kCellsPerChunk = 16;
+    const double scale = static_cast<double>(kCellsPerChunk) / m_chunkSize;
+    const int column = std::clamp(static_cast<int>(x * scale), 0, m_columns * kCellsPerChunk - 1);
+    const int row = std::clamp(static_cast<int>(y * scale), 0, m_rows * kCellsPerChunk - 1);
+    return spreadBits(static_cast<std::uint32_t>(column)) | (spreadBits(static_cast<std::uint32_t>(row)) << 1);
+}
+
+ChunkGrid::Range ChunkGrid::chunksNear(double x, double y, double radius) const
+{
+    Range range;
+    range.firstColumn = std::clamp(static_cast<int>(std::floor((x - radius) / m_chunkSize)), 0, m_columns - 1);
+    range.lastColumn = std::clamp(static_cast<int>(std::floor((x + radius) / m_chunkSize)), 0, m_columns - 1);
+    range.firstRow = std::clamp(static_cast<int>(std::floor((y - radius) / m_chunkSize)), 0, m_rows - 1);
+    range.lastRow = std::clamp(static_cast<int>(std::floor((y + radius) / m_chunkSize)), 0, m_rows - 1);
+    return range;
+}
+
+void ChunkGrid::countCreatures(const std::vector<Creature*>& creatures, bool list)
+{
+    for (auto& chunk : m_chunks) {
+        chunk.creatureCount = 0;
+        chunk.creatures.clear();
+    }
+    for (auto* creature : creatures) {
+        Chunk& chunk = m_chunks[chunkIndex(creature->x, creature->y)];
+        chunk.creatureCount += 1;
+        if (list) {
+            chunk.creatures.push_back(creature);
+        }
+    }
+}
+
+void ChunkGrid::addFood(Food* food)
+{
+    m_chunks[chunkIndex(food->x(), food->y())].foods.push_back(food);
+}
+
+void ChunkGrid::removeConsumed(const std::vector<Food*>& removed)
+{
+    for (const auto* food : removed) {
+        const int index = chunkIndex(food->x(), food->y());
+        if (!m_chunks[index].dirty) {
+            m_chunks[index].dirty = true;
+            m_dirty.push_back(index);
+        }
+    }
+
+    for (int index : m_dirty) {
+        Chunk& chunk = m_chunks[index];
+        chunk.foods.erase(std::remove_if(chunk.foods.begin(), chunk.foods.end(),
+                              [](const Food* food) { return food->consumed(); }),
+            chunk.foods.end());
+        if (chunk.foods.empty()) {
+            chunk.foods.shrink_to_fit();
+        }
+        chunk.dirty = false;
+    }
+    m_dirty.clear();
+}
+
+int ChunkGrid::emptyCount() const
+{
+    return static_cast<int>(std::count_if(m_chunks.begin(), m_chunks.end(),
+        [](const Chunk& chunk) { return chunk.creatureCount == 0; }));
+}
+
+std::size_t ChunkGrid::foodStorageBytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& chunk : m_chunks) {
+        bytes += chunk.foods.capacity() * sizeof(Food*);
+    }
+    return bytes;
+}
+
+std::size_t ChunkGrid::creatureStorageBytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& chunk : m_chunks) {
+        bytes += chunk.creatures.capacity() * sizeof(Creature*);
+    }
+    return bytes;
+}
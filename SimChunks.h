@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Creature;
+class Food;
+
+/**
+ * @brief Coarse spatial partition of the world into square chunks.
+ *
+ * Each chunk owns the list of food lying inside it and the number of creatures
+ * currently inside it, optionally with the creatures themselves. Food expiry is driven by \c FoodExpiryWheel, so chunks
+ * without creatures cost nothing per tick; only occupancy is recounted.
+ */
+class ChunkGrid {
+public:
+    /** @brief One square region of the world. */
+    struct Chunk {
+        /** @brief Food located in the chunk. */
+        std::vector<Food*> foods;
+        /** @brief Creatures inside the chunk at the start of the tick. */
+        int creatureCount = 0;
+        /** @brief Those creatures in list order, when \c countCreatures() was asked to list them. */
+        std::vector<Creature*> creatures;
+        /** @brief Set while the chunk is queued for compaction. */
+        bool dirty = false;
+    };
+
+    /** @brief Inclusive block of chunk columns and rows. */
+    struct Range {
+        int firstColumn = 0;
+        int lastColumn = 0;
+        int firstRow = 0;
+        int lastRow = 0;
+    };
+
+    /**
+     * @brief Size the grid for a world and drop all chunk contents.
+     * @param worldWidth World width.
+     * @param worldHeight World height.
+     * @param chunkSize Chunk edge length in world units.
+     */
+    void reset(double worldWidth, double worldHeight, int chunkSize);
+
+    /**
+     * @brief Chunk index containing a point.
+     * @param x X coordinate (clamped to the world).
+     * @param y Y coordinate (clamped to the world).
+     * @return Index into \c chunks().
+     */
+    int chunkIndex(double x, double y) const;
+    /**
+     * @brief Z-order (Morton) key of a point.
+     * @param x X coordinate (clamped to the world).
+     * @param y Y coordinate (clamped to the world).
+     * @return Interleaved column and row bits of the point's cell, where every
+     *         chunk is split into 16 x 16 cells; each chunk is therefore one
+     *         contiguous range of keys.
+     */
+    std::uint64_t mortonKey(double x, double y) const;
+    /**
+     * @brief Chunks overlapping the square of half-width \p radius around a point.
+     * @param x Centre x coordinate.
+     * @param y Centre y coordinate.
+     * @param radius Half-width of the square; the range is clamped to the grid.
+     * @return Block of chunks; chunk (column, row) has index row * columns() + column.
+     */
+    Range chunksNear(double x, double y, double radius) const;
+
+    /**
+     * @brief Recount creatures per chunk from their current positions.
+     * @param creatures Living creatures.
+     * @param list Also fill each chunk's \c creatures list; otherwise the lists are emptied.
+     */
+    void countCreatures(const std::vector<Creature*>& creatures, bool list = false);
+    /**
+     * @brief Register a freshly spawned food item.
+     * @param food Food to add.
+     */
+    void addFood(Food* food);
+    /**
+     * @brief Drop consumed food from the chunks that contain it.
+     * @param removed Consumed food about to be deleted.
+     * @note Each affected chunk is compacted once, however many items it loses.
+     */
+    void removeConsumed(const std::vector<Food*>& removed);
+
+    /** @brief All chunks, row-major. */
+    const std::vector<Chunk>& chunks() const { return m_chunks; }
+    /** @brief Number of chunk columns. */
+    int columns() const { return m_columns; }
+    /** @brief Number of chunk rows. */
+    int rows() const { return m_rows; }
+    /** @brief Chunk edge length in world units. */
+    int chunkSize() const { return m_chunkSize; }
+    /** @brief Number of chunks without creatures at the start of the tick. */
+    int emptyCount() const;
+    /** @brief Bytes reserved by the per-chunk food lists. */
+    std::size_t foodStorageBytes() const;
+    /** @brief Bytes reserved by the per-chunk creature lists. */
+    std::size_t creatureStorageBytes() const;
+
+private:
+    std::vector<Chunk> m_chunks;
+    std::vector<int> m_dirty;
+    int m_columns = 1;
+    int m_rows = 1;
+    int m_chunkSize = 256;
+};
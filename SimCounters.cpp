@@ -0,0 +1,268 @@
+#include "SimCounters.h"
+
+#include <algorithm>
+#include <mutex>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+
+std::mutex s_reasonMutex;
+std::string s_reason;
+
+void noteUnavailable(const std::string& reason)
+{
+    std::lock_guard<std::mutex> lock(s_reasonMutex);
+    if (s_reason.empty()) {
+        s_reason = reason;
+    }
+}
+
+#ifdef __linux__
+
+/** @brief One perf_event_open group counting the owning thread in user space. */
+struct CounterGroup {
+    struct Member {
+        CounterValues::Counter counter;
+        std::uint32_t type;
+        std::uint64_t config;
+    };
+
+    /** @brief Open descriptors; the first is the group leader. */
+    int fds[CounterValues::CounterCount] = {};
+    /** @brief Counter of each descriptor, in the order the kernel reports them. */
+    CounterValues::Counter order[CounterValues::CounterCount] = {};
+    int size = 0;
+
+    CounterGroup() = default;
+    CounterGroup(const CounterGroup&) = delete;
+    CounterGroup& operator=(const CounterGroup&) = delete;
+
+    ~CounterGroup()
+    {
+        // Members before the leader.
+        for (int i = size - 1; i >= 0; --i) {
+            close(fds[i]);
+        }
+    }
+
+    void open(const Member* members, int count, const char* label)
+    {
+        for (int i = 0; i < count; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = members[i].type;
+            attr.config = members[i].config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int leader = size > 0 ? fds[0] : -1;
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0) {
+                noteUnavailable(std::string(label) + " counter " + CounterValues::counterName(members[i].counter)
+                    + ": " + std::strerror(errno));
+                if (size == 0) {
+                    // Without a leader the rest of the group cannot open either.
+                    return;
+                }
+                continue;
+            }
+            fds[size] = fd;
+            order[size] = members[i].counter;
+            size += 1;
+        }
+    }
+
+    void read(CounterValues& out) const
+    {
+        if (size == 0) {
+            return;
+        }
+        std::uint64_t data[3 + CounterValues::CounterCount] = {};
+        if (::read(fds[0], data, sizeof(data)) <= 0) {
+            return;
+        }
+        const std::uint64_t enabled = data[1];
+        const std::uint64_t running = data[2];
+        const int reported = static_cast<int>(std::min<std::uint64_t>(data[0], size));
+        for (int i = 0; i < reported; ++i) {
+            std::uint64_t value = data[3 + i];
+            // Scale up counts the kernel only sampled part of the time.
+            if (running > 0 && running < enabled) {
+                value = static_cast<std::uint64_t>(static_cast<double>(value) * enabled / running);
+            }
+            out.values[order[i]] = value;
+        }
+    }
+
+    unsigned mask() const
+    {
+        unsigned bits = 0;
+        for (int i = 0; i < size; ++i) {
+            bits |= 1u << order[i];
+        }
+        return bits;
+    }
+};
+
+struct ThreadCounters {
+    bool opened = false;
+    CounterGroup hardware;
+    CounterGroup software;
+
+    void open()
+    {
+        static const CounterGroup::Member hardwareMembers[] = {
+            { CounterValues::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { CounterValues::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { CounterValues::CacheMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+            { CounterValues::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        };
+        static const CounterGroup::Member softwareMembers[] = {
+            { CounterValues::TaskClock, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+            { CounterValues::PageFaults, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+            { CounterValues::ContextSwitches, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+        };
+        hardware.open(hardwareMembers, 4, "hardware");
+        software.open(softwareMembers, 3, "software");
+        opened = true;
+    }
+};
+
+thread_local ThreadCounters t_counters;
+
+#endif
+
+}
+
+const char* CounterValues::counterName(int counter)
+{
+    switch (counter) {
+    case Cycles:
+        return "cycles";
+    case Instructions:
+        return "instructions";
+    case CacheMisses:
+        return "cacheMisses";
+    case BranchMisses:
+        return "branchMisses";
+    case TaskClock:
+        return "taskClockNs";
+    case PageFaults:
+        return "pageFaults";
+    case ContextSwitches:
+        return "contextSwitches";
+    default:
+        return "unknown";
+    }
+}
+
+unsigned HardwareCounters::readThread(CounterValues& out)
+{
+#ifdef __linux__
+    if (!t_counters.opened) {
+        t_counters.open();
+    }
+    t_counters.hardware.read(out);
+    t_counters.software.read(out);
+    return t_counters.hardware.mask() | t_counters.software.mask();
+#else
+    (void)out;
+    noteUnavailable("perf_event_open is only available on Linux");
+    return 0;
+#endif
+}
+
+std::string HardwareCounters::unavailableReason()
+{
+    std::lock_guard<std::mutex> lock(s_reasonMutex);
+    return s_reason;
+}
+
+const char* CounterReport::phaseName(int phase)
+{
+    switch (phase) {
+    case PhaseFood:
+        return "food";
+    case PhaseCreatures:
+        return "creatures";
+    case PhaseRemoval:
+        return "removal";
+    case PhaseBirths:
+        return "births";
+    case PhaseStats:
+        return "stats";
+    case PhaseRender:
+        return "render";
+    default:
+        return "unknown";
+    }
+}
+
+double CounterReport::ipc(int phase) const
+{
+    const std::uint64_t cycles = phases[phase].values[CounterValues::Cycles];
+    if (!has(CounterValues::Cycles) || !has(CounterValues::Instructions) || cycles == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(phases[phase].values[CounterValues::Instructions]) / cycles;
+}
+
+CounterTelemetry::PhaseMeter::PhaseMeter(CounterTelemetry* telemetry, CounterReport::Phase phase)
+    : m_telemetry(telemetry)
+    , m_phase(phase)
+{
+    if (m_telemetry) {
+        HardwareCounters::readThread(m_start);
+    }
+}
+
+CounterTelemetry::PhaseMeter::~PhaseMeter()
+{
+    stop();
+}
+
+void CounterTelemetry::PhaseMeter::next(CounterReport::Phase phase)
+{
+    if (!m_telemetry) {
+        return;
+    }
+    CounterValues now;
+    const unsigned available = HardwareCounters::readThread(now);
+    m_telemetry->add(m_phase, now - m_start, available);
+    m_phase = phase;
+    m_start = now;
+}
+
+void CounterTelemetry::PhaseMeter::stop()
+{
+    if (!m_telemetry) {
+        return;
+    }
+    CounterValues now;
+    const unsigned available = HardwareCounters::readThread(now);
+    m_telemetry->add(m_phase, now - m_start, available);
+    m_telemetry = nullptr;
+}
+
+void CounterTelemetry::add(CounterReport::Phase phase, const CounterValues& delta, unsigned available)
+{
+    m_report.enabled = true;
+    m_report.available |= available;
+    m_report.phases[phase] += delta;
+}
+
+void CounterTelemetry::endTick()
+{
+    m_report.ticks += 1;
+    m_report.unavailableReason = HardwareCounters::unavailableReason();
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Per-thread performance counter readings, or a difference of two readings.
+ */
+struct CounterValues {
+    /** @brief Counters read through perf_event_open. */
+    enum Counter {
+        /** @brief CPU cycles (hardware). */
+        Cycles = 0,
+        /** @brief Retired instructions (hardware). */
+        Instructions,
+        /** @brief Last-level cache misses (hardware). */
+        CacheMisses,
+        /** @brief Mispredicted branches (hardware). */
+        BranchMisses,
+        /** @brief Time on CPU in nanoseconds (software). */
+        TaskClock,
+        /** @brief Page faults (software). */
+        PageFaults,
+        /** @brief Context switches (software). */
+        ContextSwitches,
+        CounterCount
+    };
+
+    /** @brief Name of a counter for reports. */
+    static const char* counterName(int counter);
+
+    std::uint64_t values[CounterCount] = {};
+
+    CounterValues& operator+=(const CounterValues& other)
+    {
+        for (int i = 0; i < CounterCount; ++i) {
+            values[i] += other.values[i];
+        }
+        return *this;
+    }
+};
+
+inline CounterValues operator-(const CounterValues& a, const CounterValues& b)
+{
+    CounterValues out;
+    for (int i = 0; i < CounterValues::CounterCount; ++i) {
+        out.values[i] = a.values[i] >= b.values[i] ? a.values[i] - b.values[i] : 0;
+    }
+    return out;
+}
+
+namespace HardwareCounters {
+
+/**
+ * @brief Read the calling thread's counters, opening them on the first call.
+ * @param out Receives cumulative counts, scaled when the kernel multiplexed them.
+ * @return Bit mask of the counters that could be opened (bit \c CounterValues::Counter);
+ *         0 off Linux or where perf_event_open is refused, e.g. in containers.
+ * @note Hardware and software counters open as separate groups, so a virtual
+ *       machine without a PMU still reports task clock and page faults.
+ */
+unsigned readThread(CounterValues& out);
+/** @brief Why some counters could not be opened; empty when all opened. */
+std::string unavailableReason();
+
+}
+
+/**
+ * @brief Performance counters of one run, split by tick phase.
+ */
+struct CounterReport {
+    /** @brief Phases counters are attributed to. */
+    enum Phase {
+        /** @brief Food expiry and replenishment. */
+        PhaseFood = 0,
+        /** @brief Creature perception, decisions and movement, including strip workers. */
+        PhaseCreatures,
+        /** @brief Removal of dead creatures and consumed food. */
+        PhaseRemoval,
+        /** @brief Adding newborns. */
+        PhaseBirths,
+        /** @brief Per-tick statistics outside the environment. */
+        PhaseStats,
+        /** @brief Frame rendering and video output. */
+        PhaseRender,
+        PhaseCount
+    };
+
+    /** @brief Name of a phase for reports. */
+    static const char* phaseName(int phase);
+
+    /** @brief True when counter telemetry was attached to the run. */
+    bool enabled = false;
+    /** @brief Bit mask of counters that were available. */
+    unsigned available = 0;
+    /** @brief Why counters were missing, if any were. */
+    std::string unavailableReason;
+    /** @brief Ticks observed. */
+    int ticks = 0;
+    /** @brief Counter totals per phase. */
+    CounterValues phases[PhaseCount];
+
+    /** @brief True when a counter was available. */
+    bool has(CounterValues::Counter counter) const { return (available >> counter) & 1u; }
+    /** @brief Instructions per cycle of a phase; 0 when cycles were not counted. */
+    double ipc(int phase) const;
+};
+
+/**
+ * @brief Opt-in performance counter telemetry.
+ *
+ * Attach one to \c Environment::counterTelemetry to attribute every update's
+ * counters to its phases; callers meter their own stats and render phases with
+ * a \c PhaseMeter. Reading counters costs a system call per group at every phase
+ * boundary, so leave it detached for timing runs.
+ */
+class CounterTelemetry {
+public:
+    /**
+     * @brief Charges the calling thread's counters to consecutive phases.
+     * @note Does nothing when constructed with a null telemetry.
+     */
+    class PhaseMeter {
+    public:
+        /**
+         * @brief Start metering.
+         * @param telemetry Telemetry to charge, or nullptr.
+         * @param phase First phase.
+         */
+        PhaseMeter(CounterTelemetry* telemetry, CounterReport::Phase phase);
+        /** @brief Calls \c stop(). */
+        ~PhaseMeter();
+
+        PhaseMeter(const PhaseMeter&) = delete;
+        PhaseMeter& operator=(const PhaseMeter&) = delete;
+
+        /** @brief Charge the running phase and start another. */
+        void next(CounterReport::Phase phase);
+        /** @brief Charge the running phase and stop metering. */
+        void stop();
+
+    private:
+        CounterTelemetry* m_telemetry;
+        CounterReport::Phase m_phase;
+        CounterValues m_start;
+    };
+
+    /**
+     * @brief Charge counts read elsewhere, e.g. on worker threads, to a phase.
+     * @param phase Phase to charge.
+     * @param delta Counts to add.
+     * @param available Counters present in \c delta.
+     */
+    void add(CounterReport::Phase phase, const CounterValues& delta, unsigned available);
+    /** @brief Close one tick. */
+    void endTick();
+
+    /** @brief Report accumulated so far. */
+    const CounterReport& report() const { return m_report; }
+
+private:
+    CounterReport m_report;
+};
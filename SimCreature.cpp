@@ -3,22 +3,35 @@
 #include "SimFood.h"
 #include "SimEnvironment.h"
 
-Creature::Creature(int idValue, double xValue, double yValue, const CreatureSettings& config, double width, double height)
+Diet dietFromSettings(const QString& dietType, const QString& dietPreference)
+{
+    if (dietType == "carnivore") {
+        return Diet::Carnivore;
+    }
+    if (dietType != "omnivore") {
+        return Diet::Herbivore;
+    }
+    if (dietPreference == "Plants") {
+        return Diet::OmnivorePlants;
+    }
+    if (dietPreference == "Meat") {
+        return Diet::OmnivoreMeat;
+    }
+    return Diet::Omnivore;
+}
+
+Creature::Creature(int idValue, double xValue, double yValue, const CreatureSettings& config, const SpeciesPrototype& speciesValue)
 {
     id = idValue;
     x = xValue;
     y = yValue;
-    colorR = config.colorR;
-    colorG = config.colorG;
-    colorB = config.colorB;
+    species = &speciesValue;
     baseSpeed = config.baseSpeed;
     metabolicRate = config.metabolicRate;
     fullnessLevel = config.initialFullness;
     fullnessCap = config.fullnessCap;
     energyStorageRate = config.energyStorageRate;
     reserveEnergy = config.reserveEnergy;
-    dietType = config.dietType;
-    dietPreference = config.dietPreference;
     reproductionCost = config.reproductionCost;
     matingHungerThreshold = config.matingHungerThreshold;
     reproductionCooldown = config.reproductionCooldown;
@@ -28,13 +41,8 @@ Creature::Creature(int idValue, double xValue, double yValue, const CreatureSett
     health = config.health;
     age = config.age;
     ageCap = config.ageCap;
-    ageRate = config.ageRate;
-    speciesName = config.speciesName;
     speedMultiplier = config.speedMultiplier;
     metabolicBaseRate = config.metabolicBaseRate;
-    envWidth = width;
-    envHeight = height;
-    mutationFactor = config.mutationFactor;
     attackPower = config.attackPower;
     defencePower = config.defencePower;
     fleeExhaustionRate = config.fleeExhaustion;
@@ -42,10 +50,38 @@ Creature::Creature(int idValue, double xValue, double yValue, const CreatureSett
     skittishMultiplierBase = config.skittishMultiplierBase;
     skittishMultiplier = skittishMultiplierBase;
     skittishMultiplierScared = config.skittishMultiplierScared;
+    updateDerived();
+}
+
+Creature::Creature(int idValue, double xValue, double yValue, const SpeciesPrototype& speciesValue)
+{
+    id = idValue;
+    x = xValue;
+    y = yValue;
+    species = &speciesValue;
+}
+
+void Creature::updateDerived()
+{
+    effectiveSpeed = baseSpeed * speedMultiplier;
+    movementCostRate = metabolicBaseRate * metabolicRate;
 }
 
 void Creature::update(Environment& environment, Tracking& tracking)
 {
+    if (lodSleep > 0) {
+        lodSleep -= 1;
+        lodPending += 1;
+        return;
+    }
+    if (lodPending > 0) {
+        CreatureBehaviour::integrateIdle(*this, lodPending);
+        lodPending = 0;
+        if (dead) {
+            return;
+        }
+    }
+
     CreatureBehaviour::updateAge(*this);
     CreatureBehaviour::updateCooldowns(*this);
     CreatureBehaviour::checkSurvival(*this);
@@ -53,19 +89,30 @@ void Creature::update(Environment& environment, Tracking& tracking)
         return;
     }
 
-    CreatureBehaviour::checkSafety(*this, environment);
+    const CreatureBehaviour::Neighborhood nearby = CreatureBehaviour::perceive(*this, environment);
+    CreatureBehaviour::checkSafety(*this, nearby);
     CreatureBehaviour::checkState(*this);
 
-    if (state == "hunting") {
-        CreatureBehaviour::goHunt(*this, environment, tracking);
-    } else if (state == "mating") {
-        CreatureBehaviour::goMate(*this, environment, tracking);
-    } else if (state == "fleeing") {
+    switch (state) {
+    case CreatureState::Hunting:
+        CreatureBehaviour::goHunt(*this, nearby, environment, tracking);
+        break;
+    case CreatureState::Mating:
+        CreatureBehaviour::goMate(*this, nearby, environment, tracking);
+        break;
+    case CreatureState::Fleeing:
         CreatureBehaviour::goFlee(*this);
-    } else if (state == "resting") {
+        break;
+    case CreatureState::Resting:
         CreatureBehaviour::goRest(*this);
-    } else {
+        break;
+    default:
         CreatureBehaviour::goExplore(*this);
+        break;
+    }
+
+    if (environment.lodInterval > 1) {
+        lodSleep = CreatureBehaviour::updateInterval(*this, environment) - 1;
     }
 }
 
@@ -86,9 +133,9 @@ double Creature::getEnergyContent() const
     return size * 6.0 + (fullnessLevel / static_cast<double>(fullnessCap)) * 6.0;
 }
 
-Creature* Creature::makeBaby(const CreatureSettings& config, int newId, double xValue, double yValue)
+Creature* Creature::makeBaby(int newId, double xValue, double yValue) const
 {
-    return new Creature(newId, xValue, yValue, config, envWidth, envHeight);
+    return new Creature(newId, xValue, yValue, *species);
 }
 
 int TargetRef::id() const
@@ -3,6 +3,8 @@
 #include <QString>
 #include <limits>
 #include "MainWindow.h"
+#include "SimPrecision.h"
+#include "SimMath.h"
 
 class Food;
 class Environment;
@@ -40,21 +42,82 @@ struct TargetRef {
     double y() const;
 };
 
+/** @brief Feeding strategy of a species, resolved once from its diet settings. */
+enum class Diet {
+    Herbivore,
+    Carnivore,
+    /** @brief Omnivore without a preference. */
+    Omnivore,
+    /** @brief Omnivore weighting plants double. */
+    OmnivorePlants,
+    /** @brief Omnivore weighting prey double. */
+    OmnivoreMeat
+};
+
+/**
+ * @brief Resolve diet settings to a \c Diet.
+ * @param dietType "herbivore", "carnivore" or "omnivore"; anything else is treated as herbivore.
+ * @param dietPreference "Plants" or "Meat" for omnivores; anything else means no preference.
+ * @return Matching diet.
+ */
+Diet dietFromSettings(const QString& dietType, const QString& dietPreference);
+
+/** @brief Behaviour a creature runs on its next update. */
+enum class CreatureState {
+    /** @brief No decision yet; behaves like \c Exploring. */
+    None,
+    Hunting,
+    Mating,
+    Fleeing,
+    Resting,
+    Exploring
+};
+
+/**
+ * @brief Immutable per-species data shared by every creature of that species.
+ * @note Prototypes are owned by \c Environment::species and never move once the
+ *       environment has been set up, so creatures can hold plain pointers to them.
+ */
+struct SpeciesPrototype {
+    /** @brief Position in \c Environment::species. */
+    int index = -1;
+    QString speciesName;
+    int colorR = 0;
+    int colorG = 0;
+    int colorB = 0;
+    QString dietType;
+    QString dietPreference;
+    /** @brief \c dietType and \c dietPreference resolved for behaviour dispatch. */
+    Diet diet = Diet::Herbivore;
+    double ageRate = 0.0;
+    double mutationFactor = 0.0;
+    double envWidth = 0.0;
+    double envHeight = 0.0;
+};
+
 /**
  * @brief Creature entity for the simulation.
  */
 class Creature {
 public:
     /**
-     * @brief Create a creature from config at the given position and bounds.
+     * @brief Create a creature from config at the given position.
      * @param id Unique creature id.
      * @param x Starting x coordinate.
      * @param y Starting y coordinate.
-     * @param config Creature configuration values.
-     * @param envWidth Environment width.
-     * @param envHeight Environment height.
+     * @param config Creature configuration values for the per-creature traits.
+     * @param species Shared species prototype.
      */
-    Creature(int id, double x, double y, const CreatureSettings& config, double envWidth, double envHeight);
+    Creature(int id, double x, double y, const CreatureSettings& config, const SpeciesPrototype& species);
+    /**
+     * @brief Create a creature with default traits, to be filled in by reproduction.
+     * @param id Unique creature id.
+     * @param x Starting x coordinate.
+     * @param y Starting y coordinate.
+     * @param species Shared species prototype.
+     * @note Call \c updateDerived() after assigning traits.
+     */
+    Creature(int id, double x, double y, const SpeciesPrototype& species);
 
     /**
      * @brief Update creature state for one simulation tick.
@@ -81,31 +144,33 @@ public:
      */
     double getEnergyContent() const;
     /**
-     * @brief Spawn a baby creature from config.
-     * @param config New creature configuration.
+     * @brief Recompute constants derived from the creature's traits.
+     * @note Must be called whenever speed or metabolism traits change.
+     */
+    void updateDerived();
+    /**
+     * @brief Spawn a baby creature of the same species.
      * @param newId Unique id for the baby.
      * @param x X coordinate for the baby.
      * @param y Y coordinate for the baby.
-     * @return Newly allocated creature pointer.
+     * @return Newly allocated creature pointer with default traits.
      * @note Ownership transfers to the caller; \c Environment will delete it.
      */
-    Creature* makeBaby(const CreatureSettings& config, int newId, double x, double y);
+    Creature* makeBaby(int newId, double x, double y) const;
 
     int id = 0;
-    double x = 0.0;
-    double y = 0.0;
+    SimReal x = 0.0;
+    SimReal y = 0.0;
 
-    int colorR = 0;
-    int colorG = 0;
-    int colorB = 0;
-    double baseSpeed = 0.0;
+    /** @brief Shared species data; identity comparisons compare this pointer. */
+    const SpeciesPrototype* species = nullptr;
+
+    SimReal baseSpeed = 0.0;
     double metabolicRate = 0.0;
-    double fullnessLevel = 0.0;
+    SimReal fullnessLevel = 0.0;
     int fullnessCap = 0;
     double energyStorageRate = 0.0;
-    double reserveEnergy = 0.0;
-    QString dietType;
-    QString dietPreference;
+    SimReal reserveEnergy = 0.0;
 
     int reproductionCost = 0;
     int matingHungerThreshold = 0;
@@ -116,13 +181,8 @@ public:
     double health = 0.0;
     double age = 0.0;
     double ageCap = 0.0;
-    double ageRate = 0.0;
-    QString speciesName;
-    double speedMultiplier = 0.0;
+    SimReal speedMultiplier = 0.0;
     double metabolicBaseRate = 0.0;
-    double envWidth = 0.0;
-    double envHeight = 0.0;
-    double mutationFactor = 0.0;
     double attackPower = 0.0;
     double defencePower = 0.0;
     double fleeExhaustionRate = 0.0;
@@ -131,7 +191,12 @@ public:
     double skittishMultiplier = 0.0;
     double skittishMultiplierScared = 0.0;
 
-    QString state = "hunting";
+    /** @brief Distance covered per tick: \c baseSpeed * \c speedMultiplier. */
+    SimReal effectiveSpeed = 0.0;
+    /** @brief Fullness spent per unit moved: \c metabolicBaseRate * \c metabolicRate. */
+    SimReal movementCostRate = 0.0;
+
+    CreatureState state = CreatureState::Hunting;
     bool dead = false;
     QString deathCause;
     bool tired = false;
@@ -141,7 +206,15 @@ public:
     int fleeCount = 0;
     double fleeRecoverycooldown = std::numeric_limits<double>::quiet_NaN();
     bool hasLastDirection = false;
-    double lastDirection = 0.0;
+    /** @brief Unit heading of the exploration walk, valid when \c hasLastDirection is set. */
+    Heading lastDirection;
+
+    /** @brief Distance to the closest predator at the last safety check. */
+    double threatDistance = std::numeric_limits<double>::infinity();
+    /** @brief Ticks left to skip before the next full update (idle tier). */
+    int lodSleep = 0;
+    /** @brief Skipped ticks still to be integrated at the next full update. */
+    int lodPending = 0;
 };
 
 
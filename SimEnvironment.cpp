@@ -1,7 +1,45 @@
 #include "SimEnvironment.h"
 #include "SimRandom.h"
+#include "SimTrace.h"
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+thread_local Environment::Strip* Environment::s_activeStrip = nullptr;
+
+namespace {
+
+// Budget charge per allocation: the object plus its list entries, doubled
+// because the lists grow by reallocating into larger storage.
+constexpr std::size_t kCreatureBudgetBytes = sizeof(Creature) + 2 * sizeof(Creature*);
+constexpr std::size_t kFoodBudgetBytes = sizeof(Food) + 2 * (3 * sizeof(Food*) + sizeof(int) + 3 * sizeof(double));
+
+int roomFor(std::size_t bytesLeft, std::size_t bytesEach)
+{
+    return static_cast<int>(std::min<std::size_t>(bytesLeft / bytesEach, std::numeric_limits<int>::max()));
+}
+
+}
+
+const char* PopulationBudget::limitName(unsigned hits)
+{
+    if (hits & LimitCreatures) {
+        return "creatureBudget";
+    }
+    if (hits & LimitFood) {
+        return "foodBudget";
+    }
+    if (hits & LimitMemory) {
+        return "memoryBudget";
+    }
+    return "none";
+}
 
 
 Environment::Environment(double respawnBase,
@@ -15,13 +53,14 @@ Environment::Environment(double respawnBase,
     foodRespawnBase = respawnBase;
     foodEnergy = energy;
     baseReplicationCount = static_cast<int>(std::floor(foodRespawnBase * respawnMultiplier));
+    chunks.reset(width, height, kChunkSize);
 }
 
 
 Environment::~Environment()
 {
     for (auto* creature : creatures) {
-        delete creature;
+        releaseCreature(creature);
     }
     for (auto* food : foods) {
         delete food;
@@ -32,46 +71,368 @@ Environment::~Environment()
 void Environment::addCreature(Creature* creature)
 {
     creatures.push_back(creature);
+    traits.add(*creature);
+}
+
+
+void Environment::releaseCreature(Creature* creature)
+{
+    const std::less<const Creature*> before;
+    if (m_slab && !before(creature, m_slab) && before(creature, m_slab + m_slabCapacity)) {
+        creature->~Creature();
+        m_slabLive -= 1;
+        if (m_slabLive == 0) {
+            std::allocator<Creature>().deallocate(m_slab, m_slabCapacity);
+            m_slab = nullptr;
+            m_slabCapacity = 0;
+        }
+        return;
+    }
+    delete creature;
+}
+
+bool Environment::reorderDue() const
+{
+    if (creatures.size() < 2) {
+        return false;
+    }
+    if (reorderInterval > 0 && tick - m_reorderTick >= reorderInterval) {
+        return true;
+    }
+    return reorderDisorder > 0.0 && creatureDisorder() > reorderDisorder;
 }
 
+double Environment::creatureDisorder() const
+{
+    if (creatures.size() < 2) {
+        return 0.0;
+    }
+    int descents = 0;
+    std::uint64_t previous = chunks.mortonKey(creatures.front()->x, creatures.front()->y);
+    for (std::size_t i = 1; i < creatures.size(); ++i) {
+        const std::uint64_t key = chunks.mortonKey(creatures[i]->x, creatures[i]->y);
+        descents += key < previous;
+        previous = key;
+    }
+    return descents / static_cast<double>(creatures.size() - 1);
+}
+
+void Environment::reorderCreatures()
+{
+    m_reorderTick = tick;
+    const std::size_t count = creatures.size();
+    if (count == 0) {
+        return;
+    }
+
+    struct Entry {
+        std::uint64_t key;
+        int id;
+        Creature* creature;
+    };
+    std::pmr::vector<Entry> order(&scratch);
+    order.reserve(count);
+    for (auto* creature : creatures) {
+        order.push_back({ chunks.mortonKey(creature->x, creature->y), creature->id, creature });
+    }
+    std::sort(order.begin(), order.end(), [](const Entry& a, const Entry& b) {
+        return a.key != b.key ? a.key < b.key : a.id < b.id;
+    });
+
+    Creature* slab = std::allocator<Creature>().allocate(count);
+    // Old address to new address, sorted by old address for the pointer fix-ups.
+    std::pmr::vector<std::pair<Creature*, Creature*>> moved(&scratch);
+    moved.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Creature* to = new (slab + i) Creature(std::move(*order[i].creature));
+        moved.emplace_back(order[i].creature, to);
+        creatures[i] = to;
+    }
+    const std::less<const Creature*> before;
+    std::sort(moved.begin(), moved.end(), [&before](const auto& a, const auto& b) { return before(a.first, b.first); });
+    auto relocated = [&moved, &before](Creature* old) -> Creature* {
+        const auto found = std::lower_bound(moved.begin(), moved.end(), old,
+            [&before](const auto& entry, Creature* value) { return before(entry.first, value); });
+        return found != moved.end() && found->first == old ? found->second : nullptr;
+    };
+    for (auto* creature : creatures) {
+        if (creature->targetFood.type == TargetRef::Type::Creature) {
+            creature->targetFood.creature = relocated(creature->targetFood.creature);
+            if (!creature->targetFood.creature) {
+                creature->targetFood = TargetRef();
+            }
+        }
+        // A predator that has since died is dropped; checkSafety looks again before fleeing.
+        if (creature->predator) {
+            creature->predator = relocated(creature->predator);
+        }
+    }
+
+    // The moved-from shells go back to the heap or to the previous block,
+    // which is freed once its last creature leaves.
+    for (const auto& entry : moved) {
+        releaseCreature(entry.first);
+    }
+    m_slab = slab;
+    m_slabCapacity = count;
+    m_slabLive = count;
+    reorders += 1;
+}
 
 void Environment::addFood(Food* food)
 {
+    food->setStorageIndex(static_cast<int>(foods.size()));
     foods.push_back(food);
+    foodCompetitors.push_back(0);
+    foodX.push_back(food->x());
+    foodY.push_back(food->y());
+    foodScoreEnergy.push_back(food->energyContent());
+    chunks.addFood(food);
+    foodExpiry.schedule(food, tick);
+}
+
+void Environment::consumeFood(Food& food)
+{
+    if (food.consumed()) {
+        return;
+    }
+    food.markConsumed();
+    foodScoreEnergy[food.storageIndex()] = -std::numeric_limits<double>::infinity();
+    if (s_activeStrip) {
+        // The expiry wheel is shared; strips cancel when they are merged.
+        s_activeStrip->consumed.push_back(&food);
+        return;
+    }
+    foodExpiry.cancel(&food);
+    consumedFoods.push_back(&food);
+}
+
+FoodCandidates Environment::foodCandidates() const
+{
+    FoodCandidates candidates;
+    candidates.x = foodX.data();
+    candidates.y = foodY.data();
+    candidates.energy = foodScoreEnergy.data();
+    candidates.competitors = foodCompetitors.data();
+    candidates.count = static_cast<int>(foods.size());
+    return candidates;
+}
+
+const std::vector<Creature*>& Environment::visibleCreatures() const
+{
+    return s_activeStrip ? s_activeStrip->creatures : creatures;
+}
+
+const std::vector<Food*>& Environment::visibleFoods() const
+{
+    return s_activeStrip ? s_activeStrip->foods : foods;
+}
+
+double Environment::sensingBound() const
+{
+    double bound = sensingRadius > 0.0 ? sensingRadius : std::numeric_limits<double>::infinity();
+    if (s_activeStrip) {
+        // A creature near its strip's edge sees only the halo beyond it.
+        bound = std::min(bound, std::max(0.0, perceptionRadius));
+    }
+    return bound;
+}
+
+int Environment::newCreatureId()
+{
+    return s_activeStrip ? 0 : creatureID++;
+}
+
+bool Environment::reserveBirth()
+{
+    Strip* strip = s_activeStrip;
+    int& room = strip ? strip->birthRoom : m_birthRoom;
+    if (room <= 0) {
+        (strip ? strip->budgetHits : budgetHits) |= m_birthLimit;
+        (strip ? strip->birthsRefused : birthsRefused) += 1;
+        return false;
+    }
+    if (m_birthChance < 1.0 && SimRandom::urand() >= m_birthChance) {
+        (strip ? strip->birthsRefused : birthsRefused) += 1;
+        return false;
+    }
+    room -= 1;
+    return true;
+}
+
+std::size_t Environment::budgetBytesLeft() const
+{
+    if (budget.maxBytes == 0) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    // Lists may double on their next growth, so their current storage counts twice.
+    const MemoryTelemetry::Footprint used = footprint();
+    const std::size_t objects = creatures.size() * sizeof(Creature) + foods.size() * sizeof(Food);
+    const std::size_t bytes = 2 * (used.creatureBytes + used.foodBytes) - objects;
+    return bytes < budget.maxBytes ? budget.maxBytes - bytes : 0;
+}
+
+int Environment::claimFood(int wanted)
+{
+    int room = wanted;
+    unsigned limit = 0;
+    if (budget.maxFood > 0) {
+        const int left = std::max(0, budget.maxFood - static_cast<int>(foods.size()));
+        if (left < room) {
+            room = left;
+            limit = PopulationBudget::LimitFood;
+        }
+    }
+    if (budget.maxBytes > 0) {
+        const int left = roomFor(m_bytesLeft, kFoodBudgetBytes);
+        if (left < room) {
+            room = left;
+            limit = PopulationBudget::LimitMemory;
+        }
+        m_bytesLeft -= static_cast<std::size_t>(std::max(0, room)) * kFoodBudgetBytes;
+    }
+    budgetHits |= limit;
+    return std::max(0, room);
+}
+
+void Environment::planBirths()
+{
+    const int population = static_cast<int>(creatures.size());
+    m_birthRoom = std::numeric_limits<int>::max();
+    m_birthLimit = PopulationBudget::LimitCreatures;
+    m_birthChance = 1.0;
+    if (budget.maxCreatures > 0) {
+        m_birthRoom = std::max(0, budget.maxCreatures - population);
+    }
+    if (budget.maxBytes > 0) {
+        const int room = roomFor(m_bytesLeft, kCreatureBudgetBytes);
+        if (room < m_birthRoom) {
+            m_birthRoom = room;
+            m_birthLimit = PopulationBudget::LimitMemory;
+        }
+    }
+    if (budget.mode == PopulationBudget::SuppressBirths && m_birthRoom != std::numeric_limits<int>::max()) {
+        const double capacity = static_cast<double>(population) + m_birthRoom;
+        m_birthChance = capacity > 0.0 ? m_birthRoom / capacity : 0.0;
+    }
 }
 
 
 void Environment::setupFood()
 {
-    for (int i = 0; i < baseReplicationCount; i++) {
+    m_bytesLeft = budgetBytesLeft();
+    const int count = claimFood(baseReplicationCount);
+    for (int i = 0; i < count; i++) {
         int x = static_cast<int>(std::floor(SimRandom::urand() * width));
         int y = static_cast<int>(std::floor(SimRandom::urand() * height));
         addFood(new Food(foodID++, x, y, foodEnergy));
     }
 }
 
+QString Environment::speciesConflict(const QVector<CreatureSettings>& creatures)
+{
+    for (int c = 1; c < creatures.size(); ++c) {
+        const CreatureSettings& config = creatures[c];
+        for (int first = 0; first < c; ++first) {
+            const CreatureSettings& prototype = creatures[first];
+            if (prototype.speciesName != config.speciesName) {
+                continue;
+            }
+            QString field;
+            if (prototype.colorR != config.colorR || prototype.colorG != config.colorG || prototype.colorB != config.colorB) {
+                field = "colour";
+            } else if (dietFromSettings(prototype.dietType, prototype.dietPreference)
+                != dietFromSettings(config.dietType, config.dietPreference)) {
+                field = "diet";
+            } else if (prototype.ageRate != config.ageRate) {
+                field = "age rate";
+            } else if (prototype.mutationFactor != config.mutationFactor) {
+                field = "mutation factor";
+            }
+            if (!field.isEmpty()) {
+                return QString("Creature configs %1 and %2 share the species name \"%3\" but differ in %4.")
+                    .arg(first + 1)
+                    .arg(c + 1)
+                    .arg(config.speciesName, field);
+            }
+            break;
+        }
+    }
+    return QString();
+}
+
 void Environment::setupCreatures(const QVector<CreatureSettings>& creaturesConfig)
 {
+    // Build every prototype before spawning so creature pointers into the vector stay valid.
+    std::vector<int> configSpecies;
     for (const auto& creatureConfig : creaturesConfig) {
+        auto found = std::find_if(species.begin(), species.end(), [&](const SpeciesPrototype& prototype) {
+            return prototype.speciesName == creatureConfig.speciesName;
+        });
+        if (found != species.end()) {
+            configSpecies.push_back(found->index);
+            continue;
+        }
+
+        SpeciesPrototype prototype;
+        prototype.index = static_cast<int>(species.size());
+        prototype.speciesName = creatureConfig.speciesName;
+        prototype.colorR = creatureConfig.colorR;
+        prototype.colorG = creatureConfig.colorG;
+        prototype.colorB = creatureConfig.colorB;
+        prototype.dietType = creatureConfig.dietType;
+        prototype.dietPreference = creatureConfig.dietPreference;
+        prototype.diet = dietFromSettings(creatureConfig.dietType, creatureConfig.dietPreference);
+        prototype.ageRate = creatureConfig.ageRate;
+        prototype.mutationFactor = creatureConfig.mutationFactor;
+        prototype.envWidth = width;
+        prototype.envHeight = height;
+        species.push_back(prototype);
+        traits.addSpecies(creatureConfig);
+        configSpecies.push_back(prototype.index);
+    }
+
+    m_bytesLeft = budgetBytesLeft();
+    planBirths();
+    m_birthChance = 1.0;
+    for (int c = 0; c < creaturesConfig.size(); ++c) {
+        const CreatureSettings& creatureConfig = creaturesConfig[c];
+        const SpeciesPrototype& prototype = species[configSpecies[c]];
         for (int i = 0; i < creatureConfig.initialPopulation; i++) {
+            if (!reserveBirth()) {
+                break;
+            }
             addCreature(new Creature(
                 creatureID++,
                 std::floor(SimRandom::urand() * width),
                 std::floor(SimRandom::urand() * height),
                 creatureConfig,
-                width,
-                height));
-            if (creatureConfig.dietType != "herbivore") {
+                prototype));
+            if (prototype.diet != Diet::Herbivore) {
                 hasPredators = true;
             }
         }
     }
 }
 
+void Environment::retargetFood(const Food* oldFood, const Food* newFood)
+{
+    if (oldFood == newFood) {
+        return;
+    }
+    if (oldFood) {
+        foodCompetitors[oldFood->storageIndex()] -= 1;
+    }
+    if (newFood) {
+        foodCompetitors[newFood->storageIndex()] += 1;
+    }
+}
+
 void Environment::replenishFood()
 {
     if (SimRandom::urand() > 0.5) {
-        for (int i = 0; i < baseReplicationCount; i++) {
+        const int count = claimFood(baseReplicationCount);
+        for (int i = 0; i < count; i++) {
             int x = static_cast<int>(std::round(SimRandom::urand() * width));
             int y = static_cast<int>(std::round(SimRandom::urand() * height));
             addFood(new Food(foodID++, x, y, foodEnergy));
@@ -79,35 +440,17 @@ void Environment::replenishFood()
     }
 }
 
-void Environment::update(Tracking& tracking)
+bool Environment::updateCreatures(const std::vector<Creature*>& list,
+    Tracking& tracking,
+    std::pmr::vector<int>& removed)
 {
-    for (auto* food : foods) {
-        food->update();
-    }
-
-    replenishFood();
-
-    for (auto* creature : creatures) {
-        if (creature->targetFood.type != TargetRef::Type::None) {
-            int id = creature->targetFood.id();
-            if (id >= 0) {
-                tracking.foodCompetitionMap[id] += 1;
-            }
+    for (auto* creature : list) {
+        if (stopFlag && stopFlag->load(std::memory_order_relaxed)) {
+            return false;
         }
-    }
-
-    std::vector<int> creaturesToRemove;
-    std::vector<int> foodToRemove;
 
-    for (auto* creature : creatures) {
         creature->update(*this, tracking);
 
-        if (!tracking.preyToAdd.empty()) {
-            for (const auto& preyId : tracking.preyToAdd) {
-                creaturesToRemove.push_back(preyId);
-            }
-        }
-
         if (creature->dead) {
             const QString cause = creature->deathCause;
             if (cause == "age") {
@@ -117,11 +460,205 @@ void Environment::update(Tracking& tracking)
             } else if (cause == "predation") {
                 tracking.deathCause.predation += 1;
             }
-            tracking.deaths.push_back(creature->speciesName);
-            creaturesToRemove.push_back(creature->id);
+            tracking.deaths.push_back(creature->species->index);
+            removed.push_back(creature->id);
+        }
+    }
+    return true;
+}
+
+int Environment::planStrips() const
+{
+    if (stripCount <= 1 || width <= 0) {
+        return 1;
+    }
+
+    // Strips updated at the same time are one strip apart, so a strip must be
+    // wider than both halos for their visible sets to stay disjoint.
+    const double minimumWidth = 2.0 * std::max(0.0, perceptionRadius) + 1.0;
+    const int fit = static_cast<int>(std::floor(width / minimumWidth));
+    return std::clamp(fit, 1, stripCount);
+}
+
+void Environment::updateStrips(int stripTotal, Tracking& tracking, std::pmr::vector<int>& creaturesToRemove)
+{
+    const double stripWidth = static_cast<double>(width) / stripTotal;
+    const double halo = std::max(0.0, perceptionRadius);
+    auto stripOf = [stripWidth, stripTotal](double x) {
+        return std::clamp(static_cast<int>(x / stripWidth), 0, stripTotal - 1);
+    };
+
+    m_strips.resize(stripTotal);
+    // Drawn on the calling thread, so runs stay reproducible from its seed.
+    const auto baseSeed = static_cast<unsigned int>(SimRandom::urand() * 4294967296.0);
+    for (int s = 0; s < stripTotal; ++s) {
+        Strip& strip = m_strips[s];
+        strip.start = s * stripWidth;
+        strip.end = (s + 1) * stripWidth;
+        strip.seed = baseSeed ^ (static_cast<unsigned int>(s + 1) * 0x9E3779B9u);
+        strip.owned.clear();
+        strip.creatures.clear();
+        strip.foods.clear();
+        strip.consumed.clear();
+        strip.removed.clear();
+        strip.tracking.clear();
+        strip.budgetHits = 0;
+        strip.birthsRefused = 0;
+    }
+
+    for (auto* creature : creatures) {
+        Strip& owner = m_strips[stripOf(creature->x)];
+        owner.owned.push_back(creature);
+
+        // A food target left behind in another strip's area cannot be touched safely.
+        if (creature->targetFood.type == TargetRef::Type::Food && creature->targetFood.food) {
+            const double foodX = creature->targetFood.food->x();
+            if (foodX < owner.start - halo || foodX > owner.end + halo) {
+                retargetFood(creature->targetFood.food, nullptr);
+                creature->targetFood = TargetRef();
+            }
+        }
+
+        const int first = stripOf(creature->x - halo);
+        const int last = stripOf(creature->x + halo);
+        for (int s = first; s <= last; ++s) {
+            m_strips[s].creatures.push_back(creature);
+        }
+    }
+    // Each strip may fill a share of the birth room proportional to the creatures
+    // it owns, so which births succeed does not depend on thread timing.
+    const long long population = static_cast<long long>(creatures.size());
+    const bool limited = m_birthRoom != std::numeric_limits<int>::max() && population > 0;
+    long long roomLeft = m_birthRoom;
+    for (auto& strip : m_strips) {
+        strip.birthRoom = limited
+            ? static_cast<int>(m_birthRoom * static_cast<long long>(strip.owned.size()) / population)
+            : m_birthRoom;
+        roomLeft -= strip.birthRoom;
+    }
+    for (int s = 0; limited && roomLeft > 0; s = (s + 1) % stripTotal) {
+        m_strips[s].birthRoom += 1;
+        roomLeft -= 1;
+    }
+    for (auto* food : foods) {
+        const int first = stripOf(food->x() - halo);
+        const int last = stripOf(food->x() + halo);
+        for (int s = first; s <= last; ++s) {
+            m_strips[s].foods.push_back(food);
+        }
+    }
+
+    if (!m_stripPool) {
+        const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        const int threads = stripThreads > 0 ? stripThreads : std::max(1, hardware);
+        m_stripPool = std::make_unique<TaskPool>(threads);
+    }
+
+    std::atomic_bool stripInterrupted{ false };
+    const std::function<void(int)> runStrip = [this, &stripInterrupted](int s) {
+        SimTrace::Span trace("sim", "strip");
+        Strip& strip = m_strips[s];
+        const AllocationCounters start = SimMemory::threadCounters();
+        CounterValues countersStart;
+        if (counterTelemetry) {
+            HardwareCounters::readThread(countersStart);
+        }
+        SimRandom::seed(strip.seed);
+        s_activeStrip = &strip;
+        if (!updateCreatures(strip.owned, strip.tracking, strip.removed)) {
+            stripInterrupted = true;
+        }
+        s_activeStrip = nullptr;
+        strip.allocations = SimMemory::threadCounters() - start;
+        if (counterTelemetry) {
+            CounterValues countersEnd;
+            strip.countersAvailable = HardwareCounters::readThread(countersEnd);
+            strip.counters = countersEnd - countersStart;
         }
+    };
+
+    // Even strips first, then odd ones; neighbours of a running strip are idle.
+    for (int parity = 0; parity < 2; ++parity) {
+        const int count = (stripTotal - parity + 1) / 2;
+        m_stripPool->run(count, [&runStrip, parity](int index) { runStrip(2 * index + parity); });
     }
+    interrupted = stripInterrupted.load();
+
+    for (auto& strip : m_strips) {
+        if (memoryTelemetry) {
+            memoryTelemetry->add(MemoryReport::PhaseCreatures, strip.allocations);
+        }
+        if (counterTelemetry) {
+            counterTelemetry->add(CounterReport::PhaseCreatures, strip.counters, strip.countersAvailable);
+        }
+        for (auto* food : strip.consumed) {
+            foodExpiry.cancel(food);
+            consumedFoods.push_back(food);
+        }
+        creaturesToRemove.insert(creaturesToRemove.end(), strip.removed.begin(), strip.removed.end());
+
+        const Tracking& local = strip.tracking;
+        tracking.deaths.insert(tracking.deaths.end(), local.deaths.begin(), local.deaths.end());
+        tracking.births.insert(tracking.births.end(), local.births.begin(), local.births.end());
+        tracking.preyToAdd.insert(tracking.preyToAdd.end(), local.preyToAdd.begin(), local.preyToAdd.end());
+        tracking.deathCause.age += local.deathCause.age;
+        tracking.deathCause.hunger += local.deathCause.hunger;
+        tracking.deathCause.predation += local.deathCause.predation;
+        budgetHits |= strip.budgetHits;
+        birthsRefused += strip.birthsRefused;
+        for (auto* baby : local.newborns) {
+            baby->id = creatureID++;
+            tracking.newborns.push_back(baby);
+        }
+    }
+}
 
+void Environment::update(Tracking& tracking)
+{
+    SimTrace::Span trace("sim", "update");
+    SimTrace::Span phase("sim", "food");
+    MemoryTelemetry::PhaseMeter allocations(memoryTelemetry, MemoryReport::PhaseFood);
+    CounterTelemetry::PhaseMeter counters(counterTelemetry, CounterReport::PhaseFood);
+    scratch.reset();
+    tick += 1;
+    if (reorderDue()) {
+        SimTrace::Span reorder("sim", "reorder");
+        reorderCreatures();
+    }
+    budgetHits = 0;
+    birthsRefused = 0;
+    m_bytesLeft = budgetBytesLeft();
+    chunks.countCreatures(creatures, sensingRadius > 0.0);
+    foodExpiry.expire(tick, consumedFoods);
+    for (auto* food : consumedFoods) {
+        foodScoreEnergy[food->storageIndex()] = -std::numeric_limits<double>::infinity();
+    }
+
+    replenishFood();
+    planBirths();
+
+    phase.next("creatures");
+    allocations.next(MemoryReport::PhaseCreatures);
+    counters.next(CounterReport::PhaseCreatures);
+    maxCreatureSpeed = 0.0;
+    for (auto* creature : creatures) {
+        maxCreatureSpeed = std::max<double>(maxCreatureSpeed, creature->effectiveSpeed);
+    }
+
+    std::pmr::vector<int> creaturesToRemove(&scratch);
+
+    interrupted = false;
+    activeStrips = planStrips();
+    if (activeStrips > 1) {
+        updateStrips(activeStrips, tracking, creaturesToRemove);
+    } else {
+        interrupted = !updateCreatures(creatures, tracking, creaturesToRemove);
+    }
+    creaturesToRemove.insert(creaturesToRemove.end(), tracking.preyToAdd.begin(), tracking.preyToAdd.end());
+
+    phase.next("removal");
+    allocations.next(MemoryReport::PhaseRemoval);
+    counters.next(CounterReport::PhaseRemoval);
     if (!creaturesToRemove.empty()) {
         for (auto* creature : creatures) {
             if (creature->targetFood.type == TargetRef::Type::Creature && creature->targetFood.creature) {
@@ -134,8 +671,8 @@ void Environment::update(Tracking& tracking)
             }
         }
 
-        std::vector<Creature*> remaining;
-        remaining.reserve(creatures.size());
+        // Compact in place so removal needs no second list.
+        std::size_t kept = 0;
         for (auto* creature : creatures) {
             bool remove = false;
             for (int id : creaturesToRemove) {
@@ -145,54 +682,85 @@ void Environment::update(Tracking& tracking)
                 }
             }
             if (remove) {
-                delete creature;
+                if (creature->targetFood.type == TargetRef::Type::Food) {
+                    retargetFood(creature->targetFood.food, nullptr);
+                }
+                traits.remove(*creature);
+                releaseCreature(creature);
             } else {
-                remaining.push_back(creature);
+                creatures[kept++] = creature;
             }
         }
-        creatures = std::move(remaining);
-    }
-
-    for (auto* food : foods) {
-        if (food->consumed()) {
-            foodToRemove.push_back(food->id());
-        }
+        creatures.resize(kept);
     }
 
-    if (!foodToRemove.empty()) {
+    if (!consumedFoods.empty()) {
         for (auto* creature : creatures) {
-            if (creature->targetFood.type == TargetRef::Type::Food && creature->targetFood.food) {
-                for (int id : foodToRemove) {
-                    if (creature->targetFood.food->id() == id) {
-                        creature->targetFood = TargetRef();
-                        break;
-                    }
-                }
+            if (creature->targetFood.type == TargetRef::Type::Food &&
+                creature->targetFood.food &&
+                creature->targetFood.food->consumed())
+            {
+                creature->targetFood = TargetRef();
             }
         }
 
-        std::vector<Food*> remainingFoods;
-        remainingFoods.reserve(foods.size());
-        for (auto* food : foods) {
-            bool remove = false;
-            for (int id : foodToRemove) {
-                if (food->id() == id) {
-                    remove = true;
-                    break;
-                }
-            }
-            if (remove) {
-                delete food;
-            } else {
-                remainingFoods.push_back(food);
-            }
+        chunks.removeConsumed(consumedFoods);
+        for (auto* food : consumedFoods) {
+            // Swap-remove: the last food takes over the freed slot.
+            const int index = food->storageIndex();
+            Food* last = foods.back();
+            foods[index] = last;
+            foodCompetitors[index] = foodCompetitors.back();
+            foodX[index] = foodX.back();
+            foodY[index] = foodY.back();
+            foodScoreEnergy[index] = foodScoreEnergy.back();
+            last->setStorageIndex(index);
+            foods.pop_back();
+            foodCompetitors.pop_back();
+            foodX.pop_back();
+            foodY.pop_back();
+            foodScoreEnergy.pop_back();
+            delete food;
         }
-        foods = std::move(remainingFoods);
+        consumedFoods.clear();
     }
 
+    phase.next("births");
+    allocations.next(MemoryReport::PhaseBirths);
+    counters.next(CounterReport::PhaseBirths);
     if (!tracking.newborns.empty()) {
         for (auto* baby : tracking.newborns) {
             addCreature(baby);
         }
     }
+
+    allocations.stop();
+    counters.stop();
+    if (memoryTelemetry) {
+        memoryTelemetry->endTick(tick, footprint());
+    }
+    if (counterTelemetry) {
+        counterTelemetry->endTick();
+    }
+}
+
+MemoryTelemetry::Footprint Environment::footprint() const
+{
+    MemoryTelemetry::Footprint out;
+    out.creatures = static_cast<int>(creatures.size());
+    out.foods = static_cast<int>(foods.size());
+    // Slots of the reorder block stay reserved until the whole block is freed.
+    const std::size_t heapCreatures = creatures.size() - std::min(creatures.size(), m_slabLive);
+    out.creatureBytes = (m_slabCapacity + heapCreatures) * sizeof(Creature)
+        + creatures.capacity() * sizeof(Creature*)
+        + chunks.creatureStorageBytes();
+    out.foodBytes = foods.size() * sizeof(Food)
+        + foods.capacity() * sizeof(Food*)
+        + foodCompetitors.capacity() * sizeof(int)
+        + (foodX.capacity() + foodY.capacity() + foodScoreEnergy.capacity()) * sizeof(double)
+        + chunks.foodStorageBytes()
+        + foodExpiry.storageBytes();
+    out.scratchBytes = scratch.bytesUsed();
+    out.scratchAllocations = scratch.allocationCount();
+    return out;
 }
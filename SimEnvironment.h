@@ -1,19 +1,44 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include <vector>
-#include <unordered_map>
 #include <QString>
 #include <QVector>
 
 #include "SimCreature.h"
 #include "SimFood.h"
+#include "SimTraits.h"
+#include "SimChunks.h"
+#include "SimScratch.h"
+#include "SimParallel.h"
+#include "SimScoring.h"
+#include "SimMemory.h"
+#include "SimCounters.h"
 
 /**
  * @brief Per-tick tracking data collected during simulation updates.
+ *
+ * Construct one per tick from \c Environment::scratch so its lists live in the
+ * tick arena instead of the heap.
  */
 struct Tracking {
-    /** @brief Species names of deaths recorded this tick. */
-    QVector<QString> deaths;
+    /**
+     * @brief Create empty tracking lists.
+     * @param scratch Memory for the lists; must outlive the tracking data.
+     */
+    explicit Tracking(std::pmr::memory_resource* scratch = std::pmr::get_default_resource())
+        : deaths(scratch)
+        , births(scratch)
+        , newborns(scratch)
+        , preyToAdd(scratch)
+    {
+    }
+
+    /** @brief Species indices of deaths recorded this tick. */
+    std::pmr::vector<int> deaths;
     /**
      * @brief Death cause counters for a single tick.
      */
@@ -25,14 +50,65 @@ struct Tracking {
         /** @brief Deaths from predation. */
         int predation = 0;
     } deathCause;
-    /** @brief Species names of births recorded this tick. */
-    QVector<QString> births;
+    /** @brief Species indices of births recorded this tick. */
+    std::pmr::vector<int> births;
     /** @brief Newly spawned creatures to add after the tick. */
-    std::vector<Creature*> newborns;
+    std::pmr::vector<Creature*> newborns;
     /** @brief Prey creature ids to remove after predation. */
-    std::vector<int> preyToAdd;
-    /** @brief Map of food id to number of competitors targeting it. */
-    std::unordered_map<int, int> foodCompetitionMap;
+    std::pmr::vector<int> preyToAdd;
+
+    /** @brief Empty all lists and counters, keeping their capacity. */
+    void clear()
+    {
+        deaths.clear();
+        deathCause = DeathCause();
+        births.clear();
+        newborns.clear();
+        preyToAdd.clear();
+    }
+};
+
+/**
+ * @brief Limits on how many creatures and food items a run may allocate.
+ *
+ * Limits are turned into headroom at the start of every update, so food and
+ * newborns over budget are never allocated. The memory limit covers the
+ * storage reported by \c Environment::footprint(); list storage is counted
+ * twice so a list doubling mid-tick still fits.
+ */
+struct PopulationBudget {
+    /** @brief What happens when a limit is reached. */
+    enum Mode {
+        /** @brief Refuse the allocation and report the limit so the caller can stop. */
+        StopRun,
+        /**
+         * @brief Density-dependent birth suppression.
+         *
+         * With room for R more creatures above a population of N, each newborn
+         * survives with probability R / (N + R), so growth slows logistically
+         * towards the limit instead of running into it. Food over budget is
+         * simply not spawned.
+         */
+        SuppressBirths
+    };
+
+    /** @brief Limit bits reported in \c Environment::budgetHits. */
+    enum Limit {
+        LimitCreatures = 1,
+        LimitFood = 2,
+        LimitMemory = 4
+    };
+
+    /** @brief Name of the first limit set in \c hits, e.g. for stop reasons. */
+    static const char* limitName(unsigned hits);
+
+    /** @brief Largest creature population; 0 for no limit. */
+    int maxCreatures = 0;
+    /** @brief Largest number of food items; 0 for no limit. */
+    int maxFood = 0;
+    /** @brief Largest creature and food footprint in bytes; 0 for no limit. */
+    std::size_t maxBytes = 0;
+    Mode mode = StopRun;
 };
 
 /**
@@ -55,22 +131,76 @@ public:
                 int height);
     /**
      * @brief Release owned creatures and food.
-     * @note This destructor deletes all pointers stored in \c creatures and \c foods.
+     * @note This destructor releases all creatures in \c creatures and deletes all food in \c foods.
      */
     ~Environment();
 
     /**
      * @brief Add a creature to the environment.
      * @param creature Heap-allocated creature.
-     * @note Ownership transfers to the environment; it will delete the creature.
+     * @note Ownership transfers to the environment; it will release the creature.
      */
     void addCreature(Creature* creature);
     /**
      * @brief Add a food item to the environment.
      * @param food Heap-allocated food.
      * @note Ownership transfers to the environment; it will delete the food.
+     * @note The food is also registered with its chunk in \c chunks.
      */
     void addFood(Food* food);
+    /**
+     * @brief Mark a food item eaten and queue it for removal at the end of the tick.
+     * @param food Food being eaten; ignored when already consumed.
+     */
+    void consumeFood(Food& food);
+    /**
+     * @brief Creatures a behaviour may inspect.
+     * @return All creatures, or during a strip update the strip's creatures plus its halo.
+     */
+    const std::vector<Creature*>& visibleCreatures() const;
+    /**
+     * @brief Food a behaviour may inspect.
+     * @return All food, or during a strip update the strip's food plus its halo.
+     */
+    const std::vector<Food*>& visibleFoods() const;
+    /**
+     * @brief Distance up to which a behaviour is guaranteed to sense other creatures.
+     * @return \c sensingRadius when set, capped at \c perceptionRadius during a strip
+     *         update; infinity when everything is sensed.
+     */
+    double sensingBound() const;
+    /**
+     * @brief Id for a creature born this tick.
+     * @return The next creature id, or 0 inside a strip update, where newborns are
+     *         numbered in strip order once all strips have finished.
+     */
+    int newCreatureId();
+    /**
+     * @brief Claim room for one newborn; call before allocating it.
+     * @return False when \c budget leaves no room this tick, or when birth
+     *         suppression rejects the newborn; the refusal is counted in \c birthsRefused.
+     * @note Inside a strip update the room comes from the strip's share, so the
+     *       outcome does not depend on thread timing.
+     */
+    bool reserveBirth();
+    /**
+     * @brief Move one creature's claim from one food item to another.
+     * @param oldFood Previously targeted food, or nullptr.
+     * @param newFood Newly targeted food, or nullptr.
+     * @note Both items must still be stored in \c foods (consumed food stays until the end of the tick).
+     */
+    void retargetFood(const Food* oldFood, const Food* newFood);
+    /** @brief Number of creatures currently targeting a stored food item. */
+    int foodCompetition(const Food& food) const { return foodCompetitors[food.storageIndex()]; }
+    /** @brief All stored food as parallel arrays for \c bestFoodCandidate(). */
+    FoodCandidates foodCandidates() const;
+    /**
+     * @brief Storage currently held for creatures, food and this tick's scratch data.
+     * @note Creature bytes cover the objects, the \c creatures list and the chunk
+     *       creature lists kept for \c sensingRadius; food bytes cover the objects,
+     *       the per-food arrays, chunk lists and expiry slots.
+     */
+    MemoryTelemetry::Footprint footprint() const;
 
     /**
      * @brief Populate initial food items.
@@ -80,8 +210,18 @@ public:
     /**
      * @brief Populate initial creatures from configs.
      * @param creatures Creature configuration list.
+     * @note Configs sharing a species name share one species index, assigned in
+     *       order of first appearance, and one prototype built from the first of
+     *       them; check \c speciesConflict() first to reject configs that disagree.
      */
     void setupCreatures(const QVector<CreatureSettings>& creatures);
+    /**
+     * @brief Find configs that share a species name but not its species-wide data.
+     * @param creatures Creature configuration list.
+     * @return Description of the first conflict, or an empty string. Colour, diet,
+     *         age rate and mutation factor must match between configs of a species.
+     */
+    static QString speciesConflict(const QVector<CreatureSettings>& creatures);
     /**
      * @brief Randomly replenish food.
      * @note Replenishment is probabilistic and may add multiple food items.
@@ -89,12 +229,69 @@ public:
     void replenishFood();
     /**
      * @brief Advance environment one tick and collect tracking info.
-     * @param tracking Per-tick tracking accumulator.
+     * @param tracking Per-tick tracking accumulator, freshly constructed for this tick.
+     * @note Temporaries come from \c scratch, which is rewound at the start of the
+     *       next update; tracking built on it is only valid until then.
+     * @note When \c stopFlag is raised mid-tick the remaining creatures are skipped;
+     *       removals and births already recorded are still applied.
      */
     void update(Tracking& tracking);
+    /**
+     * @brief Fraction of neighbouring entries of \c creatures whose Morton keys
+     *        (see \c ChunkGrid::mortonKey()) are out of order.
+     * @return 0 right after \c reorderCreatures(), about 0.5 for random order.
+     */
+    double creatureDisorder() const;
+    /**
+     * @brief Sort \c creatures along a Morton curve and move them into one block.
+     *
+     * Creatures are ordered by the Morton key of their position, ties broken by
+     * id, so the result depends only on the world state. They are then moved in
+     * that order into a single contiguous allocation, and the creature pointers
+     * held by other creatures are redirected. Neighbours in space become
+     * neighbours in memory.
+     *
+     * @note Creatures update in \c creatures order, so a reorder changes which
+     *       creature acts first within later ticks; runs that reorder on the same
+     *       schedule stay reproducible.
+     * @note Any creature pointers held outside the environment are invalidated.
+     */
+    void reorderCreatures();
 
+    /**
+     * @brief Living creatures in update order.
+     * @note Insertion order with newborns appended, until \c reorderCreatures()
+     *       sorts them spatially.
+     */
     std::vector<Creature*> creatures;
+    /** @brief Live food; removal swaps the last item into the freed slot. */
     std::vector<Food*> foods;
+    /**
+     * @brief Creatures targeting each food item, indexed like \c foods.
+     * @note Maintained incrementally as targets change and creatures die.
+     */
+    std::vector<int> foodCompetitors;
+    /** @brief Food x coordinates, indexed like \c foods. */
+    std::vector<double> foodX;
+    /** @brief Food y coordinates, indexed like \c foods. */
+    std::vector<double> foodY;
+    /** @brief Food energy indexed like \c foods for scoring; -infinity once eaten or expired so scoring skips it. */
+    std::vector<double> foodScoreEnergy;
+    /** @brief Pending food expiries. */
+    FoodExpiryWheel foodExpiry;
+    /** @brief Food eaten or expired this tick, removed at the end of \c update(). */
+    std::vector<Food*> consumedFoods;
+    /**
+     * @brief Shared species prototypes, indexed by \c SpeciesPrototype::index.
+     * @note Filled once by \c setupCreatures(); creatures point into this vector.
+     */
+    std::vector<SpeciesPrototype> species;
+    /** @brief Living trait distributions, kept in sync by add and removal. */
+    TraitHistograms traits;
+    /** @brief Spatial chunks holding food lists and creature occupancy. */
+    ChunkGrid chunks;
+    /** @brief Arena for per-tick temporaries, including the caller's \c Tracking. */
+    ScratchArena scratch;
 
     int width = 0;
     int height = 0;
@@ -105,4 +302,116 @@ public:
 
     int creatureID = 1;
     int foodID = 1;
+    /** @brief Full-update interval for idle creatures; 1 updates everyone every tick. */
+    int lodInterval = 1;
+    /** @brief Fastest creature speed at the start of the tick, used for idle tiering. */
+    double maxCreatureSpeed = 0.0;
+    /** @brief Optional stop request polled between creature updates. */
+    const std::atomic_bool* stopFlag = nullptr;
+    /** @brief True when the last \c update() ended early because of \c stopFlag. */
+    bool interrupted = false;
+    /** @brief Optional allocation telemetry fed by every \c update(); not owned. */
+    MemoryTelemetry* memoryTelemetry = nullptr;
+    /** @brief Optional performance counter telemetry fed by every \c update(); not owned. */
+    CounterTelemetry* counterTelemetry = nullptr;
+    /** @brief Allocation limits applied by setup and every \c update(). */
+    PopulationBudget budget;
+    /** @brief \c PopulationBudget::Limit bits that refused an allocation in the last setup or update. */
+    unsigned budgetHits = 0;
+    /** @brief Newborns refused by the budget or suppressed during the last update. */
+    int birthsRefused = 0;
+    /** @brief Ticks between reorders at the start of \c update(); 0 disables scheduled reorders. */
+    int reorderInterval = 0;
+    /** @brief Reorder at the start of \c update() when \c creatureDisorder() exceeds this; 0 disables the check. */
+    double reorderDisorder = 0.0;
+    /** @brief Reorders performed so far. */
+    int reorders = 0;
+
+    /**
+     * @brief Vertical strips the world is split into for multi-threaded updates.
+     * @note 1 keeps the sequential update. With more strips, creatures only perceive
+     *       their own strip plus \c perceptionRadius on either side; even strips are
+     *       updated in parallel, then odd ones, so concurrently updated strips never
+     *       share a creature or food item.
+     */
+    int stripCount = 1;
+    /** @brief Threads for strip updates; 0 uses the hardware concurrency. */
+    int stripThreads = 0;
+    /** @brief Halo width each strip can see beyond its edges. */
+    double perceptionRadius = 160.0;
+    /**
+     * @brief Distance within which a creature senses threats, mates, prey, food and competitors.
+     * @note 0 senses everything in \c visibleCreatures() and \c visibleFoods(). Otherwise
+     *       sequential updates query only the chunks near each creature; strip updates
+     *       are further limited to the strip's halo.
+     */
+    double sensingRadius = 0.0;
+    /** @brief Strips used by the last update; fewer than requested when strips would be narrower than two halos. */
+    int activeStrips = 1;
+
+    /**
+     * @brief Number of updates started; the current tick inside \c update().
+     * @note Food set up before the first update spawns on tick 0.
+     */
+    int tick = 0;
+
+    /** @brief Default chunk edge length in world units. */
+    static constexpr int kChunkSize = 256;
+
+private:
+    /** @brief One vertical strip of a decomposed update. */
+    struct Strip {
+        double start = 0.0;
+        double end = 0.0;
+        unsigned int seed = 0;
+        /** @brief Creatures updated by this strip, in \c creatures order. */
+        std::vector<Creature*> owned;
+        /** @brief Creatures visible to the strip: owned plus halo. */
+        std::vector<Creature*> creatures;
+        /** @brief Food visible to the strip. */
+        std::vector<Food*> foods;
+        /** @brief Food eaten by the strip, merged into \c consumedFoods afterwards. */
+        std::vector<Food*> consumed;
+        /** @brief Ids of owned creatures that died. */
+        std::pmr::vector<int> removed;
+        /** @brief Heap allocations made by the worker while updating the strip. */
+        AllocationCounters allocations;
+        /** @brief Counters of the worker while updating the strip, when \c counterTelemetry is set. */
+        CounterValues counters;
+        unsigned countersAvailable = 0;
+        /** @brief Share of the tick's birth room. */
+        int birthRoom = 0;
+        unsigned budgetHits = 0;
+        int birthsRefused = 0;
+        Tracking tracking;
+    };
+
+    bool updateCreatures(const std::vector<Creature*>& list, Tracking& tracking, std::pmr::vector<int>& removed);
+    int planStrips() const;
+    void releaseCreature(Creature* creature);
+    bool reorderDue() const;
+    std::size_t budgetBytesLeft() const;
+    int claimFood(int wanted);
+    void planBirths();
+    void updateStrips(int stripTotal, Tracking& tracking, std::pmr::vector<int>& creaturesToRemove);
+
+    std::vector<Strip> m_strips;
+    std::unique_ptr<TaskPool> m_stripPool;
+    /** @brief Budget bytes left for this tick's allocations, or SIZE_MAX without a memory limit. */
+    std::size_t m_bytesLeft = 0;
+    /** @brief Newborns that still fit this tick. */
+    int m_birthRoom = 0;
+    /** @brief Limit that sets \c m_birthRoom. */
+    unsigned m_birthLimit = PopulationBudget::LimitCreatures;
+    /** @brief Survival probability of a newborn under birth suppression. */
+    double m_birthChance = 1.0;
+    /** @brief Block holding the creatures placed by the last reorder. */
+    Creature* m_slab = nullptr;
+    std::size_t m_slabCapacity = 0;
+    /** @brief Creatures still living in \c m_slab. */
+    std::size_t m_slabLive = 0;
+    /** @brief Tick of the last reorder. */
+    int m_reorderTick = 0;
+    /** @brief Strip being updated by the calling thread, if any. */
+    static thread_local Strip* s_activeStrip;
 };
@@ -1,5 +1,10 @@
 #include "SimFood.h"
 
+static_assert((FoodExpiryWheel::kSlots & (FoodExpiryWheel::kSlots - 1)) == 0,
+    "FoodExpiryWheel::kSlots must be a power of two");
+static_assert(FoodExpiryWheel::kSlots > Food::kLifetime,
+    "FoodExpiryWheel::kSlots must exceed the food lifetime");
+
 Food::Food(int id, double x, double y, double energyContent)
     : m_id(id)
     , m_x(x)
@@ -8,17 +13,50 @@ Food::Food(int id, double x, double y, double energyContent)
 {
 }
 
-void Food::update()
+void Food::markConsumed()
+{
+    m_consumed = true;
+    m_energyContent = 0.0;
+}
+
+void FoodExpiryWheel::schedule(Food* food, int spawnTick)
+{
+    food->m_expiryTick = spawnTick + Food::kLifetime;
+    auto& slot = m_slots[food->m_expiryTick & (kSlots - 1)];
+    food->m_wheelIndex = static_cast<int>(slot.size());
+    slot.push_back(food);
+}
+
+void FoodExpiryWheel::cancel(Food* food)
 {
-    m_duration -= 1;
-    if (m_duration <= 0) {
-        m_consumed = true;
-        m_energyContent = 0.0;
+    if (food->m_wheelIndex < 0) {
+        return;
     }
+
+    auto& slot = m_slots[food->m_expiryTick & (kSlots - 1)];
+    Food* last = slot.back();
+    slot[food->m_wheelIndex] = last;
+    last->m_wheelIndex = food->m_wheelIndex;
+    slot.pop_back();
+    food->m_wheelIndex = -1;
 }
 
-void Food::markConsumed()
+void FoodExpiryWheel::expire(int tick, std::vector<Food*>& expired)
 {
-    m_consumed = true;
-    m_energyContent = 0.0;
+    auto& slot = m_slots[tick & (kSlots - 1)];
+    for (auto* food : slot) {
+        food->m_wheelIndex = -1;
+        food->markConsumed();
+        expired.push_back(food);
+    }
+    slot.clear();
+}
+
+std::size_t FoodExpiryWheel::storageBytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& slot : m_slots) {
+        bytes += slot.capacity() * sizeof(Food*);
+    }
+    return bytes;
 }
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
+#include "SimPrecision.h"
+
 /**
  * @brief Food entity available for consumption.
  */
 class Food {
 public:
+    /** @brief Ticks a food item lasts before it expires. */
+    static constexpr int kLifetime = 500;
+
     /**
      * @brief Create a food item at the given position with energy content.
      * @param id Unique food id.
@@ -14,12 +22,6 @@ public:
      */
     Food(int id, double x, double y, double energyContent);
 
-    /**
-     * @brief Advance lifetime and mark consumed if expired.
-     * @note Decrements the internal duration counter.
-     */
-    void update();
-
     /** @brief Food id. */
     int id() const { return m_id; }
     /** @brief X coordinate. */
@@ -32,6 +34,8 @@ public:
     double energyContent() const { return m_energyContent; }
     /** @brief True when food is consumed or expired. */
     bool consumed() const { return m_consumed; }
+    /** @brief Tick on which the food expires. */
+    int expiryTick() const { return m_expiryTick; }
 
     /**
      * @brief Mark the food as consumed and clear energy.
@@ -39,12 +43,57 @@ public:
      */
     void markConsumed();
 
+    /** @brief Position in \c Environment::foods, or -1 when not stored. */
+    int storageIndex() const { return m_storageIndex; }
+    /** @brief Set the position in \c Environment::foods. */
+    void setStorageIndex(int index) { m_storageIndex = index; }
+
 private:
+    friend class FoodExpiryWheel;
+
     int m_id = 0;
-    double m_x = 0.0;
-    double m_y = 0.0;
+    SimReal m_x = 0.0;
+    SimReal m_y = 0.0;
     double m_size = 3.0;
-    double m_energyContent = 0.0;
+    SimReal m_energyContent = 0.0;
     bool m_consumed = false;
-    int m_duration = 500;
+    int m_expiryTick = 0;
+    int m_storageIndex = -1;
+    int m_wheelIndex = -1;
+};
+
+/**
+ * @brief Timing wheel of pending food expiries.
+ *
+ * Food is filed under the slot of its expiry tick (spawn tick + \c Food::kLifetime),
+ * so advancing a tick only touches the food expiring on that tick instead of
+ * counting down every item. Food eaten early is cancelled in O(1).
+ */
+class FoodExpiryWheel {
+public:
+    /** @brief Slot count; a power of two larger than \c Food::kLifetime. */
+    static constexpr int kSlots = 512;
+
+    /**
+     * @brief File a food item for expiry.
+     * @param food Food to schedule.
+     * @param spawnTick Tick the food appeared on.
+     */
+    void schedule(Food* food, int spawnTick);
+    /**
+     * @brief Remove a pending food item, e.g. because it was eaten.
+     * @param food Food to cancel; ignored when not scheduled.
+     */
+    void cancel(Food* food);
+    /**
+     * @brief Expire all food due on a tick.
+     * @param tick Current tick.
+     * @param expired Receives the expired food, marked consumed.
+     */
+    void expire(int tick, std::vector<Food*>& expired);
+    /** @brief Bytes reserved by the slot lists. */
+    std::size_t storageBytes() const;
+
+private:
+    std::vector<Food*> m_slots[kSlots];
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cmath>
+
+/**
+ * @brief Unit direction vector used for movement headings.
+ */
+struct Heading {
+    double x = 1.0;
+    double y = 0.0;
+};
+
+/** @brief Small inline math helpers for the movement hot path. */
+namespace SimMath {
+/**
+ * @brief Unit vector pointing at an angle, without calling \c std::cos / \c std::sin.
+ *
+ * Reduces the angle to a quarter turn around zero and evaluates Taylor
+ * polynomials there. For |angle| <= 7 each component is within 2.3e-16 of
+ * \c std::cos / \c std::sin (checked in test_simmath.cpp).
+ *
+ * @param angle Angle in radians.
+ * @return (cos(angle), sin(angle)).
+ */
+inline Heading unitVector(double angle)
+{
+    constexpr double kTwoOverPi = 0.63661977236758134308;
+    // pi/2 split into a head exact in double and a tail, so r keeps full precision.
+    constexpr double kHalfPiHead = 1.5707963267948966;
+    constexpr double kHalfPiTail = 6.123233995736766e-17;
+
+    const double quadrant = std::nearbyint(angle * kTwoOverPi);
+    const double r = (angle - quadrant * kHalfPiHead) - quadrant * kHalfPiTail;
+    const double r2 = r * r;
+
+    const double s = r * (1.0 + r2 * (-1.0 / 6 + r2 * (1.0 / 120 + r2 * (-1.0 / 5040 + r2 * (1.0 / 362880
+        + r2 * (-1.0 / 39916800 + r2 * (1.0 / 6227020800 + r2 * (-1.0 / 1307674368000))))))));
+    const double c = 1.0 + r2 * (-1.0 / 2 + r2 * (1.0 / 24 + r2 * (-1.0 / 720 + r2 * (1.0 / 40320
+        + r2 * (-1.0 / 3628800 + r2 * (1.0 / 479001600 + r2 * (-1.0 / 87178291200 + r2 * (1.0 / 20922789888000))))))));
+
+    switch (static_cast<long long>(quadrant) & 3) {
+    case 0:
+        return { c, s };
+    case 1:
+        return { -s, c };
+    case 2:
+        return { -c, -s };
+    default:
+        return { s, -c };
+    }
+}
+
+/**
+ * @brief Turn a heading by an angle and renormalise it.
+ * @param heading Current unit heading.
+ * @param angle Turn in radians, counter-clockwise.
+ * @return Rotated unit heading.
+ */
+inline Heading rotate(const Heading& heading, double angle)
+{
+    const Heading turn = unitVector(angle);
+    const double x = heading.x * turn.x - heading.y * turn.y;
+    const double y = heading.x * turn.y + heading.y * turn.x;
+    const double length = std::sqrt(x * x + y * y);
+    return { x / length, y / length };
+}
+}
@@ -0,0 +1,154 @@
+#include "SimMemory.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+thread_local AllocationCounters s_threadCounters;
+std::atomic_bool s_hookInstalled{ false };
+
+/** @brief Read a "<key>: <n> kB" line from /proc/self/status. */
+std::size_t readStatusKilobytes(const char* key)
+{
+    std::FILE* file = std::fopen("/proc/self/status", "r");
+    if (!file) {
+        return 0;
+    }
+
+    const std::size_t keyLength = std::strlen(key);
+    char line[256];
+    unsigned long long kilobytes = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::strncmp(line, key, keyLength) == 0 && line[keyLength] == ':') {
+            std::sscanf(line + keyLength + 1, "%llu", &kilobytes);
+            break;
+        }
+    }
+    std::fclose(file);
+    return static_cast<std::size_t>(kilobytes) * 1024;
+}
+
+}
+
+AllocationCounters& SimMemory::threadCounters()
+{
+    return s_threadCounters;
+}
+
+bool SimMemory::hookInstalled()
+{
+    return s_hookInstalled.load(std::memory_order_relaxed);
+}
+
+void SimMemory::markHookInstalled()
+{
+    s_hookInstalled.store(true, std::memory_order_relaxed);
+}
+
+std::size_t SimMemory::residentBytes()
+{
+    return readStatusKilobytes("VmRSS");
+}
+
+std::size_t SimMemory::peakResidentBytes()
+{
+    return readStatusKilobytes("VmHWM");
+}
+
+const char* MemoryReport::phaseName(int phase)
+{
+    switch (phase) {
+    case PhaseFood:
+        return "food";
+    case PhaseCreatures:
+        return "creatures";
+    case PhaseRemoval:
+        return "removal";
+    case PhaseBirths:
+        return "births";
+    default:
+        return "unknown";
+    }
+}
+
+AllocationCounters MemoryReport::total() const
+{
+    AllocationCounters sum;
+    for (const auto& phase : phases) {
+        sum += phase;
+    }
+    return sum;
+}
+
+MemoryTelemetry::PhaseMeter::PhaseMeter(MemoryTelemetry* telemetry, MemoryReport::Phase phase)
+    : m_telemetry(telemetry)
+    , m_phase(phase)
+{
+    if (m_telemetry) {
+        m_start = SimMemory::threadCounters();
+    }
+}
+
+MemoryTelemetry::PhaseMeter::~PhaseMeter()
+{
+    stop();
+}
+
+void MemoryTelemetry::PhaseMeter::next(MemoryReport::Phase phase)
+{
+    if (!m_telemetry) {
+        return;
+    }
+    const AllocationCounters now = SimMemory::threadCounters();
+    m_telemetry->add(m_phase, now - m_start);
+    m_phase = phase;
+    m_start = now;
+}
+
+void MemoryTelemetry::PhaseMeter::stop()
+{
+    if (!m_telemetry) {
+        return;
+    }
+    m_telemetry->add(m_phase, SimMemory::threadCounters() - m_start);
+    m_telemetry = nullptr;
+}
+
+void MemoryTelemetry::add(MemoryReport::Phase phase, const AllocationCounters& delta)
+{
+    m_report.phases[phase] += delta;
+    m_tickAllocations += delta.allocations;
+}
+
+void MemoryTelemetry::endTick(int tick, const Footprint& footprint)
+{
+    m_report.enabled = true;
+    m_report.heapCounted = SimMemory::hookInstalled();
+    m_report.ticks += 1;
+    if (m_tickAllocations > m_report.peakTickAllocations) {
+        m_report.peakTickAllocations = m_tickAllocations;
+        m_report.peakTick = tick;
+    }
+    m_tickAllocations = 0;
+
+    m_report.scratch.allocations += footprint.scratchAllocations;
+    m_report.scratch.bytes += footprint.scratchBytes;
+    if (footprint.scratchBytes > m_report.scratchPeakBytes) {
+        m_report.scratchPeakBytes = footprint.scratchBytes;
+    }
+    if (footprint.creatures > 0 && footprint.creatures >= m_report.peakCreatures) {
+        m_report.peakCreatures = footprint.creatures;
+        m_report.bytesPerCreature = static_cast<double>(footprint.creatureBytes) / footprint.creatures;
+    }
+    if (footprint.foods > 0 && footprint.foods >= m_report.peakFood) {
+        m_report.peakFood = footprint.foods;
+        m_report.bytesPerFood = static_cast<double>(footprint.foodBytes) / footprint.foods;
+    }
+}
+
+void MemoryTelemetry::finish()
+{
+    m_report.peakResidentBytes = SimMemory::peakResidentBytes();
+}
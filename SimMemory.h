@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Heap allocation counts of one thread, or a difference of two readings.
+ */
+struct AllocationCounters {
+    /** @brief Calls to the global allocation functions. */
+    std::uint64_t allocations = 0;
+    /** @brief Bytes requested by those calls. */
+    std::uint64_t bytes = 0;
+
+    AllocationCounters& operator+=(const AllocationCounters& other)
+    {
+        allocations += other.allocations;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+inline AllocationCounters operator-(const AllocationCounters& a, const AllocationCounters& b)
+{
+    return { a.allocations - b.allocations, a.bytes - b.bytes };
+}
+
+namespace SimMemory {
+
+/**
+ * @brief Allocation counters of the calling thread.
+ * @note They only advance in executables that link \c SimAllocHook.cpp, which
+ *       replaces the global operator new; elsewhere they stay zero.
+ */
+AllocationCounters& threadCounters();
+/** @brief True when the operator new hook is linked into the executable. */
+bool hookInstalled();
+/** @brief Record that the hook is linked; called by \c SimAllocHook.cpp at startup. */
+void markHookInstalled();
+/**
+ * @brief Current resident set size of the process (VmRSS).
+ * @return Bytes, or 0 where /proc/self/status is unavailable.
+ */
+std::size_t residentBytes();
+/**
+ * @brief Peak resident set size of the process (VmHWM).
+ * @return Bytes, or 0 where /proc/self/status is unavailable.
+ */
+std::size_t peakResidentBytes();
+
+}
+
+/**
+ * @brief Summary of one run's allocations and memory footprint.
+ */
+struct MemoryReport {
+    /** @brief Phases of \c Environment::update() that allocations are charged to. */
+    enum Phase {
+        /** @brief Food expiry and replenishment. */
+        PhaseFood = 0,
+        /** @brief Creature updates, including strip workers. */
+        PhaseCreatures,
+        /** @brief Removal of dead creatures and consumed food. */
+        PhaseRemoval,
+        /** @brief Adding newborns. */
+        PhaseBirths,
+        PhaseCount
+    };
+
+    /** @brief Name of a phase for reports. */
+    static const char* phaseName(int phase);
+
+    /** @brief True when telemetry was attached to the run. */
+    bool enabled = false;
+    /** @brief True when heap allocations were counted; false leaves the phase totals at zero. */
+    bool heapCounted = false;
+    /** @brief Updates observed. */
+    int ticks = 0;
+    /** @brief Heap allocations per phase over the whole run. */
+    AllocationCounters phases[PhaseCount];
+    /** @brief Most heap allocations made by a single update. */
+    std::uint64_t peakTickAllocations = 0;
+    /** @brief Tick of \c peakTickAllocations. */
+    int peakTick = 0;
+    /** @brief Allocations served by the tick scratch arena over the whole run. */
+    AllocationCounters scratch;
+    /** @brief Largest scratch arena use of a single update, in bytes. */
+    std::size_t scratchPeakBytes = 0;
+    /** @brief Largest creature population observed. */
+    int peakCreatures = 0;
+    /** @brief Largest food count observed. */
+    int peakFood = 0;
+    /** @brief Creature storage divided by creatures, sampled at \c peakCreatures. */
+    double bytesPerCreature = 0.0;
+    /** @brief Food storage divided by food items, sampled at \c peakFood. */
+    double bytesPerFood = 0.0;
+    /** @brief Peak resident set size of the process when the run finished; 0 when unknown. */
+    std::size_t peakResidentBytes = 0;
+
+    /** @brief Heap allocations summed over all phases. */
+    AllocationCounters total() const;
+};
+
+/**
+ * @brief Opt-in allocation telemetry for \c Environment::update().
+ *
+ * Attach one to \c Environment::memoryTelemetry to have every update charge the
+ * heap allocations of its phases and sample the storage footprint; call
+ * \c finish() after the run to fill in the peak resident set size.
+ */
+class MemoryTelemetry {
+public:
+    /**
+     * @brief Charges the calling thread's allocations to consecutive phases.
+     * @note Does nothing when constructed with a null telemetry.
+     */
+    class PhaseMeter {
+    public:
+        /**
+         * @brief Start metering.
+         * @param telemetry Telemetry to charge, or nullptr.
+         * @param phase First phase.
+         */
+        PhaseMeter(MemoryTelemetry* telemetry, MemoryReport::Phase phase);
+        /** @brief Calls \c stop(). */
+        ~PhaseMeter();
+
+        PhaseMeter(const PhaseMeter&) = delete;
+        PhaseMeter& operator=(const PhaseMeter&) = delete;
+
+        /** @brief Charge the running phase and start another. */
+        void next(MemoryReport::Phase phase);
+        /** @brief Charge the running phase and stop metering. */
+        void stop();
+
+    private:
+        MemoryTelemetry* m_telemetry;
+        MemoryReport::Phase m_phase;
+        AllocationCounters m_start;
+    };
+
+    /** @brief Storage owned by the environment at the end of an update. */
+    struct Footprint {
+        int creatures = 0;
+        int foods = 0;
+        std::size_t creatureBytes = 0;
+        std::size_t foodBytes = 0;
+        /** @brief Scratch arena bytes handed out during the update. */
+        std::size_t scratchBytes = 0;
+        /** @brief Scratch arena allocations during the update. */
+        std::uint64_t scratchAllocations = 0;
+    };
+
+    /**
+     * @brief Charge allocations made elsewhere, e.g. on worker threads, to a phase.
+     * @param phase Phase to charge.
+     * @param delta Allocations to add.
+     */
+    void add(MemoryReport::Phase phase, const AllocationCounters& delta);
+    /**
+     * @brief Close one update.
+     * @param tick Tick that just finished.
+     * @param footprint Storage sampled at the end of the update.
+     */
+    void endTick(int tick, const Footprint& footprint);
+    /** @brief Sample the process peak resident set size into the report. */
+    void finish();
+
+    /** @brief Report accumulated so far. */
+    const MemoryReport& report() const { return m_report; }
+
+private:
+    MemoryReport m_report;
+    std::uint64_t m_tickAllocations = 0;
+};
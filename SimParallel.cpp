@@ -0,0 +1,65 @@
+#include "SimParallel.h"
+
+#include <algorithm>
+
+TaskPool::TaskPool(int threads)
+{
+    const int count = std::max(1, threads);
+    m_threads.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        m_threads.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void TaskPool::run(int count, const std::function<void(int)>& task)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next = 0;
+    m_remaining = count;
+    m_generation += 1;
+    m_wake.notify_all();
+    m_done.wait(lock, [this]() { return m_remaining == 0; });
+    m_task = nullptr;
+}
+
+void TaskPool::workerLoop()
+{
+    std::uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this, &seen]() { return m_stop || m_generation != seen; });
+        if (m_stop) {
+            return;
+        }
+
+        seen = m_generation;
+        while (m_next < m_count) {
+            const int index = m_next++;
+            const auto* task = m_task;
+            lock.unlock();
+            (*task)(index);
+            lock.lock();
+            if (--m_remaining == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Small persistent thread pool for fork-join work inside a tick.
+ *
+ * \c run() hands out task indices to the worker threads and blocks until all of
+ * them have finished. The calling thread only waits, so its thread-local state
+ * (such as the \c SimRandom engine) is never touched by pool work.
+ */
+class TaskPool {
+public:
+    /**
+     * @brief Start the worker threads.
+     * @param threads Number of workers (at least one).
+     */
+    explicit TaskPool(int threads);
+    /** @brief Stop and join the worker threads. */
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    /**
+     * @brief Run \c task(0) .. \c task(count - 1) on the workers and wait for all of them.
+     * @param count Number of tasks.
+     * @param task Task body; must not throw.
+     */
+    void run(int count, const std::function<void(int)>& task);
+
+    /** @brief Number of worker threads. */
+    int threadCount() const { return static_cast<int>(m_threads.size()); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(int)>* m_task = nullptr;
+    int m_count = 0;
+    int m_next = 0;
+    int m_remaining = 0;
+    std::uint64_t m_generation = 0;
+    bool m_stop = false;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * @brief Storage type for creature and food positions, speeds and energy.
+ *
+ * \c double by default. Configuring with \c CREATURE_SIM_FLOAT_STATE=ON stores
+ * these fields as \c float, halving their footprint in the per-tick sweeps;
+ * arithmetic on them still promotes to \c double wherever it mixes with
+ * \c double values. The \c precision_drift target reports how far float runs
+ * drift from double runs on reference scenarios.
+ */
+#ifdef CREATURE_SIM_FLOAT_STATE
+using SimReal = float;
+#else
+using SimReal = double;
+#endif
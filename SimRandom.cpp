@@ -1,10 +1,20 @@
 #include "SimRandom.h"
+#include <cmath>
 #include <random>
 
 static thread_local std::mt19937 rng{std::random_device{}()};
 
 double SimRandom::urand()
-{    
-    static thread_local std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(rng);
-}
\ No newline at end of file
+{
+    // Two 32-bit draws combined the way libstdc++'s generate_canonical does it,
+    // spelled out so seeded runs give the same numbers with every standard library.
+    const double low = static_cast<double>(rng());
+    const double high = static_cast<double>(rng());
+    const double value = (low + high * 4294967296.0) / 18446744073709551616.0;
+    return value < 1.0 ? value : std::nextafter(1.0, 0.0);
+}
+
+void SimRandom::seed(unsigned int seed)
+{
+    rng.seed(seed);
+}
@@ -10,7 +10,14 @@ public:
     /**
      * @brief Return a random double in the range [0, 1).
      * @return Random double in [0, 1).
-     * @note Uses an internal \c std::mt19937 engine.
+     * @note Uses an internal \c std::mt19937 engine and a portable conversion,
+     *       so a seed yields the same sequence with every standard library.
      */
     static double urand();
+    /**
+     * @brief Reseed the calling thread's engine.
+     * @param seed Seed value; equal seeds reproduce the same sequence.
+     * @note Each thread owns its engine, so this only affects the caller.
+     */
+    static void seed(unsigned int seed);
 };
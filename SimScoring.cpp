@@ -0,0 +1,153 @@
+#include "SimScoring.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIM_SCORING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SIM_TARGET_AVX2
+#else
+#define SIM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace FoodScoring {
+
+FoodPick scalar(const FoodCandidates& candidates, double x, double y, int focusIndex, double weight)
+{
+    FoodPick pick;
+    double best = -std::numeric_limits<double>::infinity();
+    for (int i = 0; i < candidates.count; ++i) {
+        const double dx = x - candidates.x[i];
+        const double dy = y - candidates.y[i];
+        const double distance = std::max(1e-9, std::sqrt(dx * dx + dy * dy));
+        const double focus = i == focusIndex ? 3.0 : 1.0;
+        const double score =
+            ((candidates.energy[i] * focus) / distance) * (1.0 / (candidates.competitors[i] + 1)) * weight;
+        if (score > best) {
+            best = score;
+            pick.index = i;
+        }
+    }
+    pick.score = pick.index >= 0 ? best : 0.0;
+    return pick;
+}
+
+#ifdef SIM_SCORING_X86
+
+bool hasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // The OS must also save YMM state (OSXSAVE, then XCR0 bits 1 and 2), or AVX raises #UD.
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+SIM_TARGET_AVX2
+FoodPick avx2(const FoodCandidates& candidates, double x, double y, int focusIndex, double weight)
+{
+    const __m256d creatureX = _mm256_set1_pd(x);
+    const __m256d creatureY = _mm256_set1_pd(y);
+    const __m256d minimumDistance = _mm256_set1_pd(1e-9);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d three = _mm256_set1_pd(3.0);
+    const __m256d weights = _mm256_set1_pd(weight);
+    const __m256d focusLane = _mm256_set1_pd(static_cast<double>(focusIndex));
+    const __m256d step = _mm256_set1_pd(4.0);
+    const __m128i oneInt = _mm_set1_epi32(1);
+
+    __m256d lane = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+    __m256d bestScore = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    __m256d bestLane = _mm256_set1_pd(-1.0);
+
+    const int vectorEnd = candidates.count & ~3;
+    for (int i = 0; i < vectorEnd; i += 4) {
+        const __m256d dx = _mm256_sub_pd(creatureX, _mm256_loadu_pd(candidates.x + i));
+        const __m256d dy = _mm256_sub_pd(creatureY, _mm256_loadu_pd(candidates.y + i));
+        const __m256d squared = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        const __m256d distance = _mm256_max_pd(_mm256_sqrt_pd(squared), minimumDistance);
+        const __m256d focus = _mm256_blendv_pd(one, three, _mm256_cmp_pd(lane, focusLane, _CMP_EQ_OQ));
+        const __m128i competitors =
+            _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(candidates.competitors + i)), oneInt);
+        const __m256d penalty = _mm256_div_pd(one, _mm256_cvtepi32_pd(competitors));
+        const __m256d attraction = _mm256_div_pd(_mm256_mul_pd(_mm256_loadu_pd(candidates.energy + i), focus), distance);
+        const __m256d score = _mm256_mul_pd(_mm256_mul_pd(attraction, penalty), weights);
+
+        // Strictly greater keeps the earliest index of each lane on ties.
+        const __m256d better = _mm256_cmp_pd(score, bestScore, _CMP_GT_OQ);
+        bestScore = _mm256_blendv_pd(bestScore, score, better);
+        bestLane = _mm256_blendv_pd(bestLane, lane, better);
+        lane = _mm256_add_pd(lane, step);
+    }
+
+    alignas(32) double scores[4];
+    alignas(32) double lanes[4];
+    _mm256_store_pd(scores, bestScore);
+    _mm256_store_pd(lanes, bestLane);
+
+    FoodPick pick;
+    double best = -std::numeric_limits<double>::infinity();
+    for (int l = 0; l < 4; ++l) {
+        if (lanes[l] < 0.0) {
+            continue;
+        }
+        const int index = static_cast<int>(lanes[l]);
+        if (scores[l] > best || (scores[l] == best && index < pick.index)) {
+            best = scores[l];
+            pick.index = index;
+        }
+    }
+
+    FoodCandidates tail = candidates;
+    tail.x += vectorEnd;
+    tail.y += vectorEnd;
+    tail.energy += vectorEnd;
+    tail.competitors += vectorEnd;
+    tail.count -= vectorEnd;
+    const FoodPick rest = scalar(tail, x, y, focusIndex - vectorEnd, weight);
+    if (rest.index >= 0 && (pick.index < 0 || rest.score > best)) {
+        best = rest.score;
+        pick.index = rest.index + vectorEnd;
+    }
+
+    pick.score = pick.index >= 0 ? best : 0.0;
+    return pick;
+}
+
+#else
+
+bool hasAvx2()
+{
+    return false;
+}
+
+FoodPick avx2(const FoodCandidates& candidates, double x, double y, int focusIndex, double weight)
+{
+    return scalar(candidates, x, y, focusIndex, weight);
+}
+
+#endif
+
+}
+
+FoodPick bestFoodCandidate(const FoodCandidates& candidates, double x, double y, int focusIndex, double weight)
+{
+    static const auto kernel = FoodScoring::hasAvx2() ? &FoodScoring::avx2 : &FoodScoring::scalar;
+    return kernel(candidates, x, y, focusIndex, weight);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * @brief Food candidates laid out as parallel arrays, indexed like \c Environment::foods.
+ */
+struct FoodCandidates {
+    const double* x = nullptr;
+    const double* y = nullptr;
+    /** @brief Energy per candidate; -infinity marks food that must not be picked. */
+    const double* energy = nullptr;
+    /** @brief Creatures already targeting each candidate. */
+    const int* competitors = nullptr;
+    int count = 0;
+};
+
+/** @brief Best scoring candidate found by \c bestFoodCandidate(). */
+struct FoodPick {
+    /** @brief Candidate index, or -1 when no candidate scores above -infinity. */
+    int index = -1;
+    /** @brief Desirability of the picked candidate. */
+    double score = 0.0;
+};
+
+/**
+ * @brief Score every food candidate for a creature and pick the most desirable.
+ *
+ * Desirability is ((energy * focus) / distance) / (competitors + 1) * weight,
+ * with focus 3 for \p focusIndex and 1 otherwise, and distance clamped to 1e-9.
+ * Ties go to the lowest index. Uses AVX2 when the CPU supports it; every
+ * implementation performs the same operations in the same order, so all of them
+ * return identical picks.
+ *
+ * @param candidates Candidate arrays.
+ * @param x Creature x coordinate.
+ * @param y Creature y coordinate.
+ * @param focusIndex Index of the creature's current target, or -1.
+ * @param weight Diet preference multiplier.
+ * @return Best candidate.
+ */
+FoodPick bestFoodCandidate(const FoodCandidates& candidates, double x, double y, int focusIndex, double weight);
+
+/** @brief Individual implementations, exposed for tests. */
+namespace FoodScoring {
+/** @brief Portable implementation. */
+FoodPick scalar(const FoodCandidates& candidates, double x, double y, int focusIndex, double weight);
+/** @brief True when \c avx2() can run on this CPU. */
+bool hasAvx2();
+/**
+ * @brief Four-lane AVX2 implementation.
+ * @note Only call when \c hasAvx2() is true.
+ */
+FoodPick avx2(const FoodCandidates& candidates, double x, double y, int focusIndex, double weight);
+}
@@ -0,0 +1,65 @@
+#include "SimScratch.h"
+
+#include <algorithm>
+#include <cstdint>
+
+ScratchArena::ScratchArena(std::size_t initialBytes)
+    : m_initialBytes(std::max<std::size_t>(initialBytes, 256))
+{
+}
+
+void ScratchArena::reset()
+{
+    if (m_blocks.size() > 1) {
+        const std::size_t total = capacity();
+        m_blocks.clear();
+        m_blocks.push_back({ std::make_unique<std::byte[]>(total), total });
+    }
+    m_block = 0;
+    m_offset = 0;
+    m_used = 0;
+    m_allocations = 0;
+}
+
+std::size_t ScratchArena::capacity() const
+{
+    std::size_t total = 0;
+    for (const auto& block : m_blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void* ScratchArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    while (m_block < m_blocks.size()) {
+        Block& block = m_blocks[m_block];
+        const auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::size_t aligned = ((base + m_offset + alignment - 1) & ~(alignment - 1)) - base;
+        if (aligned + bytes <= block.size) {
+            m_used += aligned + bytes - m_offset;
+            m_offset = aligned + bytes;
+            m_allocations += 1;
+            return block.data.get() + aligned;
+        }
+        m_block += 1;
+        m_offset = 0;
+    }
+
+    // Out of room: add a block at least as large as everything held so far.
+    const std::size_t size = std::max({ m_initialBytes, capacity(), bytes + alignment });
+    m_blocks.push_back({ std::make_unique<std::byte[]>(size), size });
+    m_block = m_blocks.size() - 1;
+    m_offset = 0;
+    return do_allocate(bytes, alignment);
+}
+
+void ScratchArena::do_deallocate(void*, std::size_t, std::size_t)
+{
+    // Memory is reclaimed wholesale by reset().
+}
+
+bool ScratchArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
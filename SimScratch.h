@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * @brief Bump allocator for data that lives for a single tick.
+ *
+ * Allocations are carved sequentially out of retained blocks and never freed
+ * individually; \c reset() rewinds the arena at the start of the next tick.
+ * When a tick overflows into extra blocks, the next reset merges them into one
+ * block large enough for that peak, so a steady-state tick allocates nothing.
+ */
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Create an arena.
+     * @param initialBytes Size of the first block, allocated on first use.
+     */
+    explicit ScratchArena(std::size_t initialBytes = 16 * 1024);
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /**
+     * @brief Rewind the arena, invalidating everything allocated from it.
+     * @note Blocks are kept; several blocks are merged into one sized for the peak.
+     */
+    void reset();
+
+    /** @brief Bytes handed out since the last reset, including alignment padding. */
+    std::size_t bytesUsed() const { return m_used; }
+    /** @brief Allocations served since the last reset. */
+    std::size_t allocationCount() const { return m_allocations; }
+    /** @brief Total bytes held in blocks. */
+    std::size_t capacity() const;
+    /** @brief Number of blocks currently held. */
+    int blockCount() const { return static_cast<int>(m_blocks.size()); }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::vector<Block> m_blocks;
+    std::size_t m_initialBytes = 0;
+    std::size_t m_block = 0;
+    std::size_t m_offset = 0;
+    std::size_t m_used = 0;
+    std::size_t m_allocations = 0;
+};
@@ -0,0 +1,189 @@
+#include "SimStats.h"
+
+#include <algorithm>
+
+StatsPyramid::StatsPyramid(int channelCount, int capacity, int fanout)
+{
+    m_channels = std::max(0, channelCount);
+    m_fanout = std::max(2, fanout);
+    const int minimum = std::max(m_fanout, capacity);
+    m_capacity = ((minimum + m_fanout - 1) / m_fanout) * m_fanout;
+
+    Level base;
+    base.width = 1;
+    base.sums.assign(static_cast<size_t>(m_capacity) * m_channels, 0.0);
+    base.mins.assign(base.sums.size(), 0.0);
+    base.maxs.assign(base.sums.size(), 0.0);
+    m_levels.push_back(std::move(base));
+}
+
+void StatsPyramid::addLevel()
+{
+    // Only called right before the top level wraps, so its slots still hold
+    // buckets 0..capacity-1 in order and can be merged directly.
+    const Level& top = m_levels.back();
+
+    Level next;
+    next.width = top.width * m_fanout;
+    next.sums.assign(static_cast<size_t>(m_capacity) * m_channels, 0.0);
+    next.mins.assign(next.sums.size(), 0.0);
+    next.maxs.assign(next.sums.size(), 0.0);
+
+    const int merged = m_capacity / m_fanout;
+    for (int bucket = 0; bucket < merged; ++bucket) {
+        const size_t dst = static_cast<size_t>(bucket) * m_channels;
+        for (int part = 0; part < m_fanout; ++part) {
+            const size_t src = static_cast<size_t>(bucket * m_fanout + part) * m_channels;
+            for (int c = 0; c < m_channels; ++c) {
+                if (part == 0) {
+                    next.sums[dst + c] = top.sums[src + c];
+                    next.mins[dst + c] = top.mins[src + c];
+                    next.maxs[dst + c] = top.maxs[src + c];
+                } else {
+                    next.sums[dst + c] += top.sums[src + c];
+                    next.mins[dst + c] = std::min(next.mins[dst + c], top.mins[src + c]);
+                    next.maxs[dst + c] = std::max(next.maxs[dst + c], top.maxs[src + c]);
+                }
+            }
+        }
+    }
+
+    m_levels.push_back(std::move(next));
+}
+
+bool StatsPyramid::restore(int tickCount, std::vector<Level> levels)
+{
+    if (tickCount < 0 || levels.empty()) {
+        return false;
+    }
+
+    const size_t slots = static_cast<size_t>(m_capacity) * m_channels;
+    int width = 1;
+    for (const auto& level : levels) {
+        if (level.width != width || level.sums.size() != slots
+            || level.mins.size() != slots || level.maxs.size() != slots) {
+            return false;
+        }
+        width *= m_fanout;
+    }
+
+    m_ticks = tickCount;
+    m_levels = std::move(levels);
+    return true;
+}
+
+void StatsPyramid::record(const double* values)
+{
+    if (m_channels == 0) {
+        m_ticks += 1;
+        return;
+    }
+
+    if (m_ticks == m_levels.back().width * m_capacity) {
+        addLevel();
+    }
+
+    for (auto& level : m_levels) {
+        const int bucket = m_ticks / level.width;
+        const size_t offset = static_cast<size_t>(bucket % m_capacity) * m_channels;
+        if (m_ticks % level.width == 0) {
+            for (int c = 0; c < m_channels; ++c) {
+                level.sums[offset + c] = values[c];
+                level.mins[offset + c] = values[c];
+                level.maxs[offset + c] = values[c];
+            }
+        } else {
+            for (int c = 0; c < m_channels; ++c) {
+                level.sums[offset + c] += values[c];
+                level.mins[offset + c] = std::min(level.mins[offset + c], values[c]);
+                level.maxs[offset + c] = std::max(level.maxs[offset + c], values[c]);
+            }
+        }
+    }
+
+    m_ticks += 1;
+}
+
+int StatsPyramid::firstBucket(int level) const
+{
+    return std::max(0, endBucket(level) - m_capacity);
+}
+
+int StatsPyramid::endBucket(int level) const
+{
+    const int width = m_levels[level].width;
+    return (m_ticks + width - 1) / width;
+}
+
+int StatsPyramid::bucketTicks(int level, int bucket) const
+{
+    const int width = m_levels[level].width;
+    return std::max(0, std::min(width, m_ticks - bucket * width));
+}
+
+double StatsPyramid::value(int level, int bucket, int channel, Stat stat) const
+{
+    const Level& data = m_levels[level];
+    const size_t index = static_cast<size_t>(bucket % m_capacity) * m_channels + channel;
+    switch (stat) {
+    case Stat::Sum:
+        return data.sums[index];
+    case Stat::Min:
+        return data.mins[index];
+    case Stat::Max:
+        return data.maxs[index];
+    case Stat::Mean:
+        break;
+    }
+    const int ticks = bucketTicks(level, bucket);
+    return ticks > 0 ? data.sums[index] / ticks : 0.0;
+}
+
+int StatsPyramid::bestLevel(int startTick, int endTick, int maxPoints) const
+{
+    if (m_ticks == 0 || m_channels == 0) {
+        return -1;
+    }
+
+    startTick = std::clamp(startTick, 0, m_ticks - 1);
+    endTick = std::clamp(endTick, startTick + 1, m_ticks);
+
+    for (int l = 0; l < levelCount(); ++l) {
+        const int width = m_levels[l].width;
+        const int first = startTick / width;
+        const int last = (endTick + width - 1) / width;
+        if (first >= firstBucket(l) && last - first <= std::max(1, maxPoints)) {
+            return l;
+        }
+    }
+    return levelCount() - 1;
+}
+
+std::vector<double> StatsPyramid::series(int level,
+                                         int channel,
+                                         Stat stat,
+                                         int startTick,
+                                         int endTick,
+                                         std::vector<int>* ticks) const
+{
+    std::vector<double> out;
+    if (ticks) {
+        ticks->clear();
+    }
+    if (level < 0 || level >= levelCount() || channel < 0 || channel >= m_channels) {
+        return out;
+    }
+
+    const int width = m_levels[level].width;
+    const int first = std::max(firstBucket(level), std::max(0, startTick) / width);
+    const int last = std::min(endBucket(level), (std::min(endTick, m_ticks) + width - 1) / width);
+
+    out.reserve(std::max(0, last - first));
+    for (int bucket = first; bucket < last; ++bucket) {
+        out.push_back(value(level, bucket, channel, stat));
+        if (ticks) {
+            ticks->push_back(bucket * width);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @brief Fixed-memory, multi-resolution recorder for per-tick counters.
+ *
+ * Level 0 stores single ticks, every further level aggregates \c fanout buckets
+ * of the level below (tick, x8, x64, ...). Each bucket keeps the sum, minimum and
+ * maximum of every channel. Levels are rings of \c capacity buckets that retain
+ * the most recent history; a coarser level is added whenever the current top level
+ * would start evicting, so the top level always spans the whole run and memory
+ * stays at roughly <tt>capacity * channels * log_fanout(ticks / capacity)</tt>.
+ */
+class StatsPyramid {
+public:
+    /** @brief Aggregate reported for a bucket. */
+    enum class Stat {
+        Mean,
+        Sum,
+        Min,
+        Max
+    };
+
+    /**
+     * @brief Storage for one resolution level.
+     * @note Bucket \c b covers ticks <tt>[b * width, (b + 1) * width)</tt> and lives in
+     *       ring slot <tt>b % capacity</tt>, channel-major within the slot.
+     */
+    struct Level {
+        /** @brief Ticks aggregated into one bucket. */
+        int width = 1;
+        /** @brief Per-slot channel sums. */
+        std::vector<double> sums;
+        /** @brief Per-slot channel minimums. */
+        std::vector<double> mins;
+        /** @brief Per-slot channel maximums. */
+        std::vector<double> maxs;
+    };
+
+    /**
+     * @brief Create an empty pyramid.
+     * @param channelCount Number of values recorded per tick.
+     * @param capacity Buckets retained per level; rounded up to a multiple of \c fanout.
+     * @param fanout Buckets of one level merged into a bucket of the next.
+     */
+    explicit StatsPyramid(int channelCount = 0, int capacity = 1024, int fanout = 8);
+
+    /**
+     * @brief Record one tick worth of channel values.
+     * @param values Pointer to \c channelCount() values.
+     */
+    void record(const double* values);
+    /**
+     * @brief Record one tick worth of channel values.
+     * @param values Channel values; must hold \c channelCount() entries.
+     */
+    void record(const std::vector<double>& values) { record(values.data()); }
+
+    /** @brief Number of values recorded per tick. */
+    int channelCount() const { return m_channels; }
+    /** @brief Buckets retained per level. */
+    int capacity() const { return m_capacity; }
+    /** @brief Merge factor between adjacent levels. */
+    int fanout() const { return m_fanout; }
+    /** @brief Number of ticks recorded so far. */
+    int tickCount() const { return m_ticks; }
+    /** @brief Number of resolution levels currently kept. */
+    int levelCount() const { return static_cast<int>(m_levels.size()); }
+    /** @brief Raw storage of a level. */
+    const Level& level(int index) const { return m_levels[index]; }
+
+    /**
+     * @brief Replace the recorded data with previously saved raw levels.
+     * @param tickCount Ticks recorded when the levels were saved.
+     * @param levels Raw levels as returned by \c level(), finest first.
+     * @return False, leaving the pyramid unchanged, when the levels do not match
+     *         this pyramid's channel count, capacity and fanout.
+     */
+    bool restore(int tickCount, std::vector<Level> levels);
+
+    /**
+     * @brief Index of the first bucket still retained by a level.
+     * @param level Level index.
+     * @return First retained bucket index.
+     */
+    int firstBucket(int level) const;
+    /**
+     * @brief One past the last bucket recorded by a level.
+     * @param level Level index.
+     * @return Bucket count including a trailing partial bucket.
+     */
+    int endBucket(int level) const;
+    /**
+     * @brief Number of ticks aggregated into a bucket.
+     * @param level Level index.
+     * @param bucket Bucket index.
+     * @return Tick count (less than the level width for the trailing bucket).
+     */
+    int bucketTicks(int level, int bucket) const;
+    /**
+     * @brief Read an aggregate from a retained bucket.
+     * @param level Level index.
+     * @param bucket Bucket index in <tt>[firstBucket(level), endBucket(level))</tt>.
+     * @param channel Channel index.
+     * @param stat Aggregate to return.
+     * @return Requested aggregate value.
+     */
+    double value(int level, int bucket, int channel, Stat stat) const;
+
+    /**
+     * @brief Pick the finest level able to show a tick range.
+     * @param startTick First tick of the range.
+     * @param endTick One past the last tick of the range.
+     * @param maxPoints Maximum number of buckets wanted.
+     * @return Level index, or -1 when nothing has been recorded.
+     * @note Falls back to the top level when no level satisfies \c maxPoints.
+     */
+    int bestLevel(int startTick, int endTick, int maxPoints) const;
+    /**
+     * @brief Extract a channel series from one level.
+     * @param level Level index.
+     * @param channel Channel index.
+     * @param stat Aggregate to report per bucket.
+     * @param startTick First tick of the range.
+     * @param endTick One past the last tick of the range.
+     * @param ticks Optional output receiving the first tick of each bucket.
+     * @return One value per bucket intersecting the range.
+     */
+    std::vector<double> series(int level,
+                               int channel,
+                               Stat stat,
+                               int startTick,
+                               int endTick,
+                               std::vector<int>* ticks = nullptr) const;
+
+private:
+    void addLevel();
+
+    int m_channels = 0;
+    int m_capacity = 0;
+    int m_fanout = 8;
+    int m_ticks = 0;
+    std::vector<Level> m_levels;
+};
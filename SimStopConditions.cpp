@@ -0,0 +1,132 @@
+#include "SimStopConditions.h"
+
+#include "SimTraits.h"
+
+#include <algorithm>
+#include <cmath>
+
+const char* StopConditions::reasonName(int reason)
+{
+    switch (reason) {
+    case None:
+        return "completed";
+    case AllExtinct:
+        return "allExtinct";
+    case SpeciesExtinct:
+        return "speciesExtinct";
+    case SpeciesSetExtinct:
+        return "speciesSetExtinct";
+    case SteadyState:
+        return "steadyState";
+    default:
+        return "unknown";
+    }
+}
+
+StopConditions::StopConditions(const StopConditionSettings& settings, int speciesCount)
+    : m_settings(settings)
+    , m_speciesCount(std::max(0, speciesCount))
+    , m_channels(m_speciesCount * (1 + TraitHistograms::TraitCount))
+    , m_seenAlive(m_speciesCount, 0)
+{
+    m_settings.steadyWindow = std::max(0, m_settings.steadyWindow);
+    m_settings.steadyTolerance = std::max(0.0, m_settings.steadyTolerance);
+    if (m_settings.steadyWindow > 0) {
+        m_ring.assign(static_cast<std::size_t>(2) * m_settings.steadyWindow * m_channels, 0.0);
+        m_olderSum.assign(m_channels, 0.0);
+        m_newerSum.assign(m_channels, 0.0);
+        m_sample.assign(m_channels, 0.0);
+    }
+}
+
+StopConditions::Reason StopConditions::check(const TraitHistograms& traits, int tick)
+{
+    if (m_reason != None) {
+        return m_reason;
+    }
+
+    int total = 0;
+    int firstExtinct = -1;
+    for (int s = 0; s < m_speciesCount; ++s) {
+        const int population = traits.population(s);
+        total += population;
+        if (population > 0) {
+            m_seenAlive[s] = 1;
+        } else if (m_seenAlive[s] && firstExtinct < 0) {
+            firstExtinct = s;
+        }
+    }
+
+    Reason reason = None;
+    if (total == 0) {
+        reason = AllExtinct;
+    } else if (m_settings.anySpeciesExtinct && firstExtinct >= 0) {
+        reason = SpeciesExtinct;
+        m_species = firstExtinct;
+    } else if (!m_settings.extinctSet.empty()
+        && std::all_of(m_settings.extinctSet.begin(), m_settings.extinctSet.end(), [&](int s) {
+               return s < 0 || s >= m_speciesCount || traits.population(s) == 0;
+           })) {
+        reason = SpeciesSetExtinct;
+    } else if (m_settings.steadyWindow > 0) {
+        sample(traits);
+        if (steady()) {
+            reason = SteadyState;
+        }
+    }
+
+    if (reason != None) {
+        m_reason = reason;
+        m_tick = tick;
+    }
+    return reason;
+}
+
+void StopConditions::sample(const TraitHistograms& traits)
+{
+    for (int s = 0; s < m_speciesCount; ++s) {
+        double* channel = &m_sample[s * (1 + TraitHistograms::TraitCount)];
+        channel[0] = traits.population(s);
+        for (int trait = 0; trait < TraitHistograms::TraitCount; ++trait) {
+            channel[1 + trait] = traits.mean(s, trait);
+        }
+    }
+
+    // Push into the newer window; its oldest sample moves to the older window,
+    // whose oldest sample is the one being overwritten.
+    const long long window = m_settings.steadyWindow;
+    const long long ringSize = 2 * window;
+    double* slot = &m_ring[static_cast<std::size_t>(m_samples % ringSize) * m_channels];
+    const double* moved = m_samples >= window
+        ? &m_ring[static_cast<std::size_t>((m_samples - window) % ringSize) * m_channels]
+        : nullptr;
+    for (int c = 0; c < m_channels; ++c) {
+        if (m_samples >= ringSize) {
+            m_olderSum[c] -= slot[c];
+        }
+        if (moved) {
+            m_newerSum[c] -= moved[c];
+            m_olderSum[c] += moved[c];
+        }
+        slot[c] = m_sample[c];
+        m_newerSum[c] += m_sample[c];
+    }
+    m_samples += 1;
+}
+
+bool StopConditions::steady() const
+{
+    const long long window = m_settings.steadyWindow;
+    if (m_samples < 2 * window) {
+        return false;
+    }
+    for (int c = 0; c < m_channels; ++c) {
+        const double older = m_olderSum[c] / window;
+        const double newer = m_newerSum[c] / window;
+        const double scale = std::max(std::abs(older), std::abs(newer));
+        if (std::abs(newer - older) > m_settings.steadyTolerance * scale) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+
+class TraitHistograms;
+
+/**
+ * @brief Configurable reasons to end a run before its full length.
+ */
+struct StopConditionSettings {
+    /** @brief Stop once any species that was alive has died out. */
+    bool anySpeciesExtinct = false;
+    /** @brief Stop once every listed species index is extinct; empty disables the check. */
+    std::vector<int> extinctSet;
+    /**
+     * @brief Ticks per steady-state window; 0 disables the check.
+     *
+     * The run is steady when the mean of every species count and trait mean
+     * over the last window differs from the mean over the window before it by
+     * no more than \c steadyTolerance (relative).
+     */
+    int steadyWindow = 0;
+    /** @brief Allowed relative change between consecutive windows. */
+    double steadyTolerance = 0.02;
+};
+
+/**
+ * @brief Evaluates stop conditions once per tick from the trait histograms.
+ *
+ * Extinction of every creature always stops the run. Checks read only the
+ * incrementally maintained per-species populations and trait means, so a tick
+ * costs O(species * traits) regardless of population size; the steady-state
+ * windows are kept in a ring buffer allocated up front.
+ */
+class StopConditions {
+public:
+    /** @brief Why a run stopped. */
+    enum Reason {
+        /** @brief Keep running. */
+        None = 0,
+        /** @brief No creatures remain. */
+        AllExtinct,
+        /** @brief A species that had been alive died out; see \c species(). */
+        SpeciesExtinct,
+        /** @brief Every species of \c StopConditionSettings::extinctSet is extinct. */
+        SpeciesSetExtinct,
+        /** @brief Consecutive windows of counts and trait means agree within tolerance. */
+        SteadyState
+    };
+
+    /** @brief Stable identifier of a reason, used in saved results. */
+    static const char* reasonName(int reason);
+
+    /**
+     * @brief Prepare the checks.
+     * @param settings Conditions to evaluate.
+     * @param speciesCount Number of species registered with the trait histograms.
+     */
+    StopConditions(const StopConditionSettings& settings, int speciesCount);
+
+    /**
+     * @brief Evaluate all conditions after one tick.
+     * @param traits Current per-species distributions.
+     * @param tick One-based tick that just completed.
+     * @return Reason to stop, or \c None. Once a reason is returned it is kept.
+     */
+    Reason check(const TraitHistograms& traits, int tick);
+
+    /** @brief Reason returned by \c check(), or \c None. */
+    Reason reason() const { return m_reason; }
+    /** @brief Species that went extinct for \c SpeciesExtinct, otherwise -1. */
+    int species() const { return m_species; }
+    /** @brief Tick at which the run was stopped, or 0. */
+    int tick() const { return m_tick; }
+
+private:
+    bool steady() const;
+    void sample(const TraitHistograms& traits);
+
+    StopConditionSettings m_settings;
+    int m_speciesCount;
+    int m_channels;
+    std::vector<char> m_seenAlive;
+    // Ring of 2 * steadyWindow samples; the older half and newer half are summed separately.
+    std::vector<double> m_ring;
+    std::vector<double> m_olderSum;
+    std::vector<double> m_newerSum;
+    std::vector<double> m_sample;
+    long long m_samples = 0;
+    Reason m_reason = None;
+    int m_species = -1;
+    int m_tick = 0;
+};
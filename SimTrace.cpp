@@ -0,0 +1,216 @@
+#include "SimTrace.h"
+
+#ifdef CREATURE_SIM_TRACING
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* category = nullptr;
+    const char* name = nullptr;
+    std::int64_t start = 0;
+    std::int64_t duration = 0;
+};
+
+/**
+ * @brief Ring of one thread's events.
+ *
+ * Only the owning thread writes; \c written is published with release order
+ * so an exporter sees every slot below it filled in.
+ */
+struct ThreadBuffer {
+    int id = 0;
+    std::string name;
+    std::uint64_t session = 0;
+    std::vector<Event> events;
+    std::atomic<std::uint64_t> written{ 0 };
+};
+
+std::mutex s_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+/** @brief Buffers of exited threads, handed to the next thread that registers. */
+std::vector<ThreadBuffer*> s_freeBuffers;
+std::size_t s_capacity = 1 << 16;
+std::atomic<std::uint64_t> s_session{ 0 };
+thread_local std::string t_threadName;
+
+/** @brief The calling thread's buffer; returned to \c s_freeBuffers when the thread exits. */
+struct BufferSlot {
+    ThreadBuffer* buffer = nullptr;
+
+    ~BufferSlot()
+    {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(s_registryMutex);
+            s_freeBuffers.push_back(buffer);
+        }
+    }
+};
+thread_local BufferSlot t_slot;
+
+const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+/** @brief Buffer of the calling thread for the current session, registered on first use. */
+ThreadBuffer& threadBuffer()
+{
+    const std::uint64_t session = s_session.load(std::memory_order_acquire);
+    ThreadBuffer* buffer = t_slot.buffer;
+    if (buffer && buffer->session == session) {
+        return *buffer;
+    }
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    if (!buffer) {
+        if (s_freeBuffers.empty()) {
+            s_buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = s_buffers.back().get();
+            buffer->id = static_cast<int>(s_buffers.size());
+        } else {
+            buffer = s_freeBuffers.back();
+            s_freeBuffers.pop_back();
+        }
+        t_slot.buffer = buffer;
+        buffer->name = t_threadName;
+        // Within a session the exited thread's events stay; this thread continues its track.
+        if (buffer->session == session && !buffer->events.empty()) {
+            return *buffer;
+        }
+    }
+    // A buffer left over from an earlier session starts again empty.
+    buffer->session = session;
+    buffer->name = t_threadName;
+    buffer->events.assign(s_capacity, Event());
+    buffer->written.store(0, std::memory_order_release);
+    return *buffer;
+}
+
+void writeEscaped(std::FILE* file, const std::string& text)
+{
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', file);
+        }
+        if (static_cast<unsigned char>(c) >= 0x20) {
+            std::fputc(c, file);
+        }
+    }
+}
+
+}
+
+std::atomic_bool SimTrace::Detail::g_enabled{ false };
+
+void SimTrace::start(std::size_t eventsPerThread)
+{
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    std::size_t capacity = 1;
+    while (capacity < eventsPerThread) {
+        capacity <<= 1;
+    }
+    s_capacity = capacity;
+    // Threads notice the new session on their next event and reset their rings.
+    s_session.fetch_add(1, std::memory_order_release);
+    Detail::g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void SimTrace::stop()
+{
+    Detail::g_enabled.store(false, std::memory_order_relaxed);
+}
+
+bool SimTrace::enabled()
+{
+    return Detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+void SimTrace::setThreadName(const std::string& name)
+{
+    t_threadName = name;
+    if (t_slot.buffer) {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        t_slot.buffer->name = name;
+    }
+}
+
+std::int64_t SimTrace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+void SimTrace::record(const char* category, const char* name, std::int64_t start, std::int64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    const std::uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    buffer.events[index & (buffer.events.size() - 1)] = { category, name, start, end - start };
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+bool SimTrace::writeChromeJson(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    const std::uint64_t session = s_session.load(std::memory_order_acquire);
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    for (const auto& buffer : s_buffers) {
+        if (buffer->session != session) {
+            continue;
+        }
+
+        if (!buffer->name.empty()) {
+            std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"",
+                first ? "" : ",\n", buffer->id);
+            writeEscaped(file, buffer->name);
+            std::fputs("\"}}", file);
+            first = false;
+        }
+
+        const std::uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const std::uint64_t capacity = buffer->events.size();
+        const std::uint64_t begin = written > capacity ? written - capacity : 0;
+        for (std::uint64_t i = begin; i < written; ++i) {
+            const Event& event = buffer->events[i & (capacity - 1)];
+            std::fprintf(file, "%s{\"ph\":\"X\",\"cat\":\"%s\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",\n", event.category, event.name, buffer->id,
+                event.start / 1000.0, event.duration / 1000.0);
+            first = false;
+        }
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+#else
+
+void SimTrace::start(std::size_t)
+{
+}
+
+void SimTrace::stop()
+{
+}
+
+bool SimTrace::enabled()
+{
+    return false;
+}
+
+void SimTrace::setThreadName(const std::string&)
+{
+}
+
+bool SimTrace::writeChromeJson(const std::string&)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Optional phase tracing exported as Chrome trace-event JSON.
+ *
+ * Spans are recorded into a ring buffer owned by the recording thread, so
+ * recording takes no lock; only a thread's first event while tracing registers
+ * its buffer. A thread's buffer is reused by the next thread to register after
+ * it exits, so memory follows the peak number of live threads rather than every
+ * pool thread ever started. \c writeChromeJson() produces a file that opens in Perfetto or
+ * chrome://tracing. When the build sets \c CREATURE_SIM_TRACING to OFF every
+ * call compiles to nothing; when tracing is compiled in but not started, a span
+ * costs a single test of the enabled flag.
+ */
+namespace SimTrace {
+
+/**
+ * @brief Start recording, dropping events from any earlier session.
+ * @param eventsPerThread Ring capacity for each thread; the oldest events are
+ *        overwritten once a thread records more. Rounded up to a power of two.
+ */
+void start(std::size_t eventsPerThread = 1 << 16);
+/** @brief Stop recording; events stay available for \c writeChromeJson(). */
+void stop();
+/** @brief True while recording. */
+bool enabled();
+/**
+ * @brief Name the calling thread in exported traces.
+ * @param name Thread name, e.g. "sim worker".
+ */
+void setThreadName(const std::string& name);
+/**
+ * @brief Write the recorded events as Chrome trace-event JSON.
+ * @param path Output file.
+ * @return False when the file cannot be written.
+ * @note Call after \c stop(); threads still recording may overwrite events being written.
+ */
+bool writeChromeJson(const std::string& path);
+
+#ifdef CREATURE_SIM_TRACING
+
+/** @brief Current time on the trace clock, in nanoseconds. */
+std::int64_t now();
+/**
+ * @brief Record one complete span on the calling thread.
+ * @param category Category literal; must outlive the session.
+ * @param name Name literal; must outlive the session.
+ * @param start Begin time from \c now().
+ * @param end End time from \c now().
+ */
+void record(const char* category, const char* name, std::int64_t start, std::int64_t end);
+
+namespace Detail {
+/** @brief Enabled flag read inline by \c Span. */
+extern std::atomic_bool g_enabled;
+}
+
+/**
+ * @brief Records the time between construction and destruction, or between
+ *        consecutive \c next() calls, as spans.
+ */
+class Span {
+public:
+    /**
+     * @brief Open a span.
+     * @param category Category literal.
+     * @param name Name literal.
+     */
+    Span(const char* category, const char* name)
+        : m_category(category)
+    {
+        if (Detail::g_enabled.load(std::memory_order_relaxed)) {
+            m_name = name;
+            m_start = now();
+        }
+    }
+    ~Span() { end(); }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    /**
+     * @brief Close the running span and open the next one in the same category.
+     * @param name Name literal of the next span.
+     */
+    void next(const char* name)
+    {
+        if (m_name) {
+            const std::int64_t time = now();
+            record(m_category, m_name, m_start, time);
+            m_name = name;
+            m_start = time;
+        }
+    }
+
+    /** @brief Close the running span early. */
+    void end()
+    {
+        if (m_name) {
+            record(m_category, m_name, m_start, now());
+            m_name = nullptr;
+        }
+    }
+
+private:
+    const char* m_category;
+    const char* m_name = nullptr;
+    std::int64_t m_start = 0;
+};
+
+#else
+
+class Span {
+public:
+    Span(const char*, const char*) {}
+    void next(const char*) {}
+    void end() {}
+};
+
+#endif
+
+}
@@ -0,0 +1,98 @@
+#include "SimTraits.h"
+#include "SimCreature.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr int kLitterBuckets = 16;
+
+void setRange(double& lower, double& upper, double initial)
+{
+    lower = 0.0;
+    upper = initial > 0.0 ? initial * 2.0 : 1.0;
+}
+}
+
+const char* TraitHistograms::traitName(int trait)
+{
+    switch (trait) {
+    case BaseSpeed:
+        return "baseSpeed";
+    case AttackPower:
+        return "attackPower";
+    case LitterSize:
+        return "litterSize";
+    default:
+        return "";
+    }
+}
+
+double TraitHistograms::traitValue(const Creature& creature, int trait)
+{
+    switch (trait) {
+    case BaseSpeed:
+        return creature.baseSpeed;
+    case AttackPower:
+        return creature.attackPower;
+    case LitterSize:
+        return creature.litterSize;
+    default:
+        return 0.0;
+    }
+}
+
+int TraitHistograms::addSpecies(const CreatureSettings& config, int buckets)
+{
+    Species species;
+    setRange(species.traits[BaseSpeed].lower, species.traits[BaseSpeed].upper, config.baseSpeed);
+    setRange(species.traits[AttackPower].lower, species.traits[AttackPower].upper, config.attackPower);
+    species.traits[BaseSpeed].counts.assign(std::max(1, buckets), 0);
+    species.traits[AttackPower].counts.assign(std::max(1, buckets), 0);
+
+    // Litter sizes are integers: one bucket per size, centred on the value.
+    species.traits[LitterSize].lower = 0.5;
+    species.traits[LitterSize].upper = kLitterBuckets + 0.5;
+    species.traits[LitterSize].counts.assign(kLitterBuckets, 0);
+
+    for (auto& histogram : species.traits) {
+        histogram.scale = histogram.counts.size() / (histogram.upper - histogram.lower);
+    }
+
+    m_species.push_back(species);
+    return static_cast<int>(m_species.size()) - 1;
+}
+
+void TraitHistograms::apply(const Creature& creature, int delta)
+{
+    if (!creature.species || creature.species->index < 0 || creature.species->index >= speciesCount()) {
+        return;
+    }
+
+    Species& species = m_species[creature.species->index];
+    species.population += delta;
+    for (int trait = 0; trait < TraitCount; ++trait) {
+        Histogram& histogram = species.traits[trait];
+        const double value = traitValue(creature, trait);
+        const int last = static_cast<int>(histogram.counts.size()) - 1;
+        const int bucket = std::clamp(static_cast<int>(std::floor((value - histogram.lower) * histogram.scale)), 0, last);
+        histogram.counts[bucket] += delta;
+        histogram.sum += value * delta;
+    }
+}
+
+void TraitHistograms::add(const Creature& creature)
+{
+    apply(creature, 1);
+}
+
+void TraitHistograms::remove(const Creature& creature)
+{
+    apply(creature, -1);
+}
+
+double TraitHistograms::mean(int species, int trait) const
+{
+    const Species& data = m_species[species];
+    return data.population > 0 ? data.traits[trait].sum / data.population : 0.0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+
+class Creature;
+struct CreatureSettings;
+
+/**
+ * @brief Incrementally maintained per-species trait distributions.
+ *
+ * Every species gets a fixed-range histogram per tracked trait, derived from its
+ * initial configuration. Creatures are added on spawn and removed on death, so
+ * the distribution of the living population is always current without rescanning.
+ * Values outside a histogram's range are counted in the first or last bucket.
+ */
+class TraitHistograms {
+public:
+    /** @brief Traits tracked for every species. */
+    enum Trait {
+        BaseSpeed,
+        AttackPower,
+        LitterSize,
+        TraitCount
+    };
+
+    /**
+     * @brief Display name of a trait.
+     * @param trait Trait index.
+     * @return Trait name matching the \c Creature field.
+     */
+    static const char* traitName(int trait);
+    /**
+     * @brief Read a trait value from a creature.
+     * @param creature Creature to read.
+     * @param trait Trait index.
+     * @return Current trait value.
+     */
+    static double traitValue(const Creature& creature, int trait);
+
+    /**
+     * @brief Register a species and derive its histogram ranges.
+     * @param config Initial species configuration.
+     * @param buckets Buckets per continuous trait histogram.
+     * @return Index of the new species.
+     */
+    int addSpecies(const CreatureSettings& config, int buckets = 24);
+    /** @brief Number of registered species. */
+    int speciesCount() const { return static_cast<int>(m_species.size()); }
+
+    /**
+     * @brief Count a creature into its species histograms.
+     * @param creature Creature being added; uses \c creature.species->index.
+     */
+    void add(const Creature& creature);
+    /**
+     * @brief Remove a creature from its species histograms.
+     * @param creature Creature being removed; uses \c creature.species->index.
+     */
+    void remove(const Creature& creature);
+
+    /** @brief Living creatures of a species. */
+    int population(int species) const { return m_species[species].population; }
+    /** @brief Histogram bucket counts of a species trait. */
+    const std::vector<int>& counts(int species, int trait) const { return m_species[species].traits[trait].counts; }
+    /** @brief Lower edge of a species trait histogram. */
+    double lower(int species, int trait) const { return m_species[species].traits[trait].lower; }
+    /** @brief Upper edge of a species trait histogram. */
+    double upper(int species, int trait) const { return m_species[species].traits[trait].upper; }
+    /**
+     * @brief Mean trait value of the living population.
+     * @param species Species index.
+     * @param trait Trait index.
+     * @return Mean value, or 0 when the species is extinct.
+     */
+    double mean(int species, int trait) const;
+
+private:
+    struct Histogram {
+        double lower = 0.0;
+        double upper = 1.0;
+        double scale = 1.0;
+        double sum = 0.0;
+        std::vector<int> counts;
+    };
+
+    struct Species {
+        int population = 0;
+        Histogram traits[TraitCount];
+    };
+
+    void apply(const Creature& creature, int delta);
+
+    std::vector<Species> m_species;
+};
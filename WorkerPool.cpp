@@ -0,0 +1,291 @@
+#include "WorkerPool.h"
+#include "DataStore.h"
+#include "WorkerProtocol.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace {
+QByteArray progressToBytes(const SimulationProgress& progress)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << qint32(progress.tick) << qint32(progress.totalTicks) << progress.ticksPerSecond
+        << qint32(progress.population) << progress.etaSeconds;
+    return data;
+}
+
+SimulationProgress progressFromBytes(const QByteArray& data)
+{
+    SimulationProgress progress;
+    qint32 tick = 0;
+    qint32 totalTicks = 0;
+    qint32 population = 0;
+    QDataStream in(data);
+    in >> tick >> totalTicks >> progress.ticksPerSecond >> population >> progress.etaSeconds;
+    progress.tick = tick;
+    progress.totalTicks = totalTicks;
+    progress.population = population;
+    return progress;
+}
+
+SimulationResult failedResult(const QString& status, const QString& reason)
+{
+    SimulationResult result;
+    result.datetime = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    result.status = status;
+    result.stopReason = status;
+    result.failureReason = reason;
+    return result;
+}
+
+// A worker that keeps dying without ever taking a job is not restarted again.
+constexpr int kMaxIdleExits = 3;
+}
+
+WorkerPool::WorkerPool(int workerCount, QObject* parent)
+    : QObject(parent)
+{
+    m_workers.resize(std::max(1, workerCount));
+    for (int i = 0; i < m_workers.size(); ++i) {
+        startWorker(i);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    m_shuttingDown = true;
+    for (auto& worker : m_workers) {
+        if (!worker.process) {
+            continue;
+        }
+
+        worker.process->disconnect(this);
+        // Idle workers exit on EOF; busy ones are killed, which also ends their ffmpeg pipe.
+        worker.process->closeWriteChannel();
+        if (worker.jobId >= 0 || !worker.process->waitForFinished(1000)) {
+            worker.process->kill();
+            worker.process->waitForFinished(1000);
+        }
+    }
+}
+
+void WorkerPool::submit(int jobId, const SimulationSettings& sim, const QVector<CreatureSettings>& creatures)
+{
+    PendingJob job;
+    job.jobId = jobId;
+    job.scenario = DataStore::serializeScenario(sim, creatures);
+    m_queue.push_back(job);
+    dispatch();
+    failQueueWithoutWorkers("No worker processes are running.");
+}
+
+void WorkerPool::cancel(int jobId)
+{
+    for (int i = 0; i < m_queue.size(); ++i) {
+        if (m_queue[i].jobId == jobId) {
+            m_queue.removeAt(i);
+            emit jobFinished(jobId, failedResult("cancelled", "Simulation cancelled before it started."));
+            return;
+        }
+    }
+
+    for (auto& worker : m_workers) {
+        if (worker.jobId == jobId && worker.process) {
+            worker.cancelling = true;
+            worker.process->kill();
+            return;
+        }
+    }
+}
+
+void WorkerPool::startWorker(int index)
+{
+    Worker& worker = m_workers[index];
+    const int idleExits = worker.idleExits;
+    worker = Worker();
+    worker.idleExits = idleExits;
+
+    auto* process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    connect(process, &QProcess::started, this, [this, index]() {
+        m_workers[index].pid = m_workers[index].process->processId();
+        dispatch();
+    });
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, index]() {
+        onReadyRead(index);
+    });
+    connect(process, &QProcess::finished, this, [this, index](int exitCode, QProcess::ExitStatus status) {
+        onWorkerExited(index, exitCode, status);
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, index](QProcess::ProcessError error) {
+        onWorkerError(index, error);
+    });
+
+    worker.process = process;
+    process->start(QCoreApplication::applicationFilePath(), { "--worker" });
+}
+
+void WorkerPool::dispatch()
+{
+    for (auto& worker : m_workers) {
+        if (m_queue.isEmpty()) {
+            return;
+        }
+        if (!worker.process || worker.jobId >= 0 || worker.process->state() != QProcess::Running) {
+            continue;
+        }
+
+        const PendingJob job = m_queue.takeFirst();
+        worker.jobId = job.jobId;
+        worker.idleExits = 0;
+        worker.process->write(WorkerProtocol::makeFrame(WorkerProtocol::FrameScenario, job.scenario));
+    }
+}
+
+void WorkerPool::onReadyRead(int index)
+{
+    Worker& worker = m_workers[index];
+    worker.buffer.append(worker.process->readAllStandardOutput());
+
+    char type = 0;
+    QByteArray payload;
+    while (WorkerProtocol::takeFrame(worker.buffer, type, payload)) {
+        if (worker.jobId < 0) {
+            continue;
+        }
+
+        if (type == WorkerProtocol::FrameProgress) {
+            emit jobProgress(worker.jobId, progressFromBytes(payload));
+        } else if (type == WorkerProtocol::FrameResult) {
+            SimulationResult result;
+            QString error;
+            if (!DataStore::deserializeResultBinary(payload, result, &error)) {
+                result = failedResult("failed", error);
+            }
+            finishJob(index, result);
+        }
+    }
+}
+
+void WorkerPool::onWorkerExited(int index, int exitCode, QProcess::ExitStatus status)
+{
+    if (m_shuttingDown) {
+        return;
+    }
+
+    Worker& worker = m_workers[index];
+    if (worker.jobId >= 0) {
+        if (worker.cancelling) {
+            finishJob(index, failedResult("cancelled", "Simulation cancelled."));
+        } else if (status == QProcess::CrashExit) {
+            finishJob(index, failedResult("failed", "Worker process crashed."));
+        } else {
+            finishJob(index, failedResult("failed", QString("Worker process exited with code %1.").arg(exitCode)));
+        }
+    } else {
+        worker.idleExits += 1;
+    }
+
+    worker.process->deleteLater();
+    worker.process = nullptr;
+    if (worker.idleExits < kMaxIdleExits) {
+        startWorker(index);
+        return;
+    }
+    failQueueWithoutWorkers("All worker processes have exited.");
+}
+
+void WorkerPool::onWorkerError(int index, QProcess::ProcessError error)
+{
+    if (error != QProcess::FailedToStart || m_shuttingDown) {
+        return;
+    }
+
+    // No finished() follows a failed start, so the slot is retired here.
+    Worker& worker = m_workers[index];
+    worker.process->deleteLater();
+    worker.process = nullptr;
+    failQueueWithoutWorkers("Unable to start worker processes.");
+}
+
+void WorkerPool::failQueueWithoutWorkers(const QString& message)
+{
+    const bool anyAlive = std::any_of(m_workers.cbegin(), m_workers.cend(), [](const Worker& w) {
+        return w.process != nullptr;
+    });
+    if (anyAlive) {
+        return;
+    }
+    while (!m_queue.isEmpty()) {
+        const PendingJob job = m_queue.takeFirst();
+        emit jobFinished(job.jobId, failedResult("failed", message));
+    }
+}
+
+void WorkerPool::finishJob(int index, SimulationResult result)
+{
+    Worker& worker = m_workers[index];
+    const int jobId = worker.jobId;
+    worker.jobId = -1;
+    worker.cancelling = false;
+
+    result.nodeType = nodeName(index);
+    emit jobFinished(jobId, result);
+    dispatch();
+}
+
+QString WorkerPool::nodeName(int index) const
+{
+    return QString("local-worker-%1 (pid %2)").arg(index + 1).arg(m_workers[index].pid);
+}
+
+int WorkerPool::runWorker()
+{
+    QFile input;
+    QFile output;
+    if (!WorkerProtocol::openStdio(input, output)) {
+        return 1;
+    }
+
+    auto send = [&output](char type, const QByteArray& payload) {
+        output.write(WorkerProtocol::makeFrame(type, payload));
+        output.flush();
+    };
+
+    for (;;) {
+        char header[4];
+        if (!WorkerProtocol::readExactly(input, header, sizeof(header))) {
+            return 0; // Coordinator closed the pipe.
+        }
+
+        const quint32 length = qFromBigEndian<quint32>(header);
+        QByteArray frame(static_cast<qsizetype>(length), Qt::Uninitialized);
+        if (length == 0 || !WorkerProtocol::readExactly(input, frame.data(), length) || frame.at(0) != WorkerProtocol::FrameScenario) {
+            return 1;
+        }
+
+        SimulationSettings sim;
+        QVector<CreatureSettings> creatures;
+        QString error;
+        if (!DataStore::deserializeScenario(frame.mid(1), sim, creatures, &error)) {
+            send(WorkerProtocol::FrameResult, DataStore::serializeResultBinary(failedResult("failed", error)));
+            continue;
+        }
+
+        SimWorker worker;
+        worker.setInputs(sim, creatures);
+        QObject::connect(&worker, &SimWorker::progress, [&send](const SimulationProgress& progress) {
+            send(WorkerProtocol::FrameProgress, progressToBytes(progress));
+        });
+        QObject::connect(&worker, &SimWorker::finishedWithResult, [&send](const SimulationResult& result) {
+            send(WorkerProtocol::FrameResult, DataStore::serializeResultBinary(result));
+        });
+        worker.run();
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QObject>
+#include <QProcess>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include "MainWindow.h"
+
+// Runs simulations in separate worker processes (this executable started with
+// --worker) so a crashing or runaway scenario cannot take down the GUI or the
+// rest of a sweep. Scenarios go to a worker over its stdin; progress and the
+// binary result come back over its stdout as length-prefixed frames.
+class WorkerPool : public QObject {
+    Q_OBJECT
+public:
+    explicit WorkerPool(int workerCount, QObject* parent = nullptr);
+    ~WorkerPool() override;
+
+    void submit(int jobId, const SimulationSettings& sim, const QVector<CreatureSettings>& creatures);
+    void cancel(int jobId);
+    int workerCount() const { return m_workers.size(); }
+
+    // Entry point of a worker process; serves scenarios from stdin until EOF.
+    static int runWorker();
+
+signals:
+    void jobProgress(int jobId, const SimulationProgress& progress);
+    void jobFinished(int jobId, const SimulationResult& result);
+
+private:
+    struct Worker {
+        QProcess* process = nullptr;
+        int jobId = -1;
+        qint64 pid = 0;
+        QByteArray buffer;
+        int idleExits = 0;
+        bool cancelling = false;
+    };
+
+    struct PendingJob {
+        int jobId = -1;
+        QByteArray scenario;
+    };
+
+    void startWorker(int index);
+    void dispatch();
+    void onReadyRead(int index);
+    void onWorkerExited(int index, int exitCode, QProcess::ExitStatus status);
+    void onWorkerError(int index, QProcess::ProcessError error);
+    void finishJob(int index, SimulationResult result);
+    // Fails every queued job when no worker process is left to run it.
+    void failQueueWithoutWorkers(const QString& message);
+    QString nodeName(int index) const;
+
+    QVector<Worker> m_workers;
+    QList<PendingJob> m_queue;
+    bool m_shuttingDown = false;
+};
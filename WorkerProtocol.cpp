@@ -0,0 +1,61 @@
+#include "WorkerProtocol.h"
+
+#include <QFile>
+#include <QtEndian>
+
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace WorkerProtocol {
+QByteArray makeFrame(char type, const QByteArray& payload)
+{
+    QByteArray frame(4, Qt::Uninitialized);
+    qToBigEndian<quint32>(static_cast<quint32>(payload.size() + 1), frame.data());
+    frame.append(type);
+    frame.append(payload);
+    return frame;
+}
+
+bool takeFrame(QByteArray& buffer, char& type, QByteArray& payload)
+{
+    if (buffer.size() < 4) {
+        return false;
+    }
+    const quint32 length = qFromBigEndian<quint32>(buffer.constData());
+    if (length == 0 || static_cast<quint32>(buffer.size()) - 4 < length) {
+        return false;
+    }
+
+    type = buffer.at(4);
+    payload = buffer.mid(5, static_cast<qsizetype>(length) - 1);
+    buffer.remove(0, static_cast<qsizetype>(length) + 4);
+    return true;
+}
+
+bool readExactly(QIODevice& device, char* data, qint64 size)
+{
+    qint64 done = 0;
+    while (done < size) {
+        const qint64 read = device.read(data + done, size - done);
+        if (read <= 0) {
+            return false;
+        }
+        done += read;
+    }
+    return true;
+}
+
+bool openStdio(QFile& input, QFile& output)
+{
+#ifdef Q_OS_WIN
+    if (_setmode(_fileno(stdin), _O_BINARY) == -1 || _setmode(_fileno(stdout), _O_BINARY) == -1) {
+        return false;
+    }
+#endif
+    return input.open(stdin, QIODevice::ReadOnly) && output.open(stdout, QIODevice::WriteOnly);
+}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QByteArray>
+
+class QFile;
+class QIODevice;
+
+// Frames exchanged between WorkerPool and its worker processes over stdin/stdout.
+// Frame: big-endian quint32 length of (type + payload), one type byte, payload.
+namespace WorkerProtocol {
+enum FrameType : char {
+    FrameScenario = 'S',
+    FrameProgress = 'P',
+    FrameResult = 'R'
+};
+
+QByteArray makeFrame(char type, const QByteArray& payload);
+// Removes the first complete frame from buffer; false while none is complete.
+bool takeFrame(QByteArray& buffer, char& type, QByteArray& payload);
+// Blocks until size bytes arrive; false on end of file or error.
+bool readExactly(QIODevice& device, char* data, qint64 size);
+// Opens the process's stdin and stdout for frames. On Windows the C runtime opens
+// them in text mode, which rewrites 0x0A and stops at 0x1A; they are switched to
+// binary first.
+bool openStdio(QFile& input, QFile& output);
+}
@@ -1,10 +1,50 @@
 #include <QApplication>
+#include <QCoreApplication>
+#include <cstring>
 #include "MainWindow.h"
+#include "SimTrace.h"
+#include "WorkerPool.h"
+
+// CREATURE_SIM_TRACE=<file> records a Chrome trace of the session and writes it
+// on exit; worker processes append ".worker-<pid>" to the file name.
+static QString tracePath(bool worker)
+{
+    const QString path = qEnvironmentVariable("CREATURE_SIM_TRACE");
+    if (path.isEmpty() || !worker) {
+        return path;
+    }
+    return QString("%1.worker-%2").arg(path).arg(QCoreApplication::applicationPid());
+}
+
+static int finishTrace(const QString& path, int exitCode)
+{
+    if (!path.isEmpty()) {
+        SimTrace::stop();
+        SimTrace::writeChromeJson(path.toStdString());
+    }
+    return exitCode;
+}
 
 int main(int argc, char* argv[]) {
-    QApplication app(argc, argv);
     qRegisterMetaType<SimulationResult>("SimulationResult");
+    qRegisterMetaType<SimulationProgress>("SimulationProgress");
+
+    if (argc > 1 && std::strcmp(argv[1], "--worker") == 0) {
+        QCoreApplication app(argc, argv);
+        const QString trace = tracePath(true);
+        if (!trace.isEmpty()) {
+            SimTrace::start();
+        }
+        return finishTrace(trace, WorkerPool::runWorker());
+    }
+
+    QApplication app(argc, argv);
+    const QString trace = tracePath(false);
+    if (!trace.isEmpty()) {
+        SimTrace::start();
+        SimTrace::setThreadName("gui");
+    }
     MainWindow w;
     w.show();
-    return app.exec();
+    return finishTrace(trace, app.exec());
 }
@@ -0,0 +1,499 @@
+// Throughput regression gate.
+//
+// Runs fixed-seed scenario episodes repeatedly for a wall-time budget, keeps
+// the fastest episode of each scenario and divides its ticks/s by the speed of
+// a fixed calibration loop, so results are comparable across ordinary
+// machines. Fails when a scenario falls more than the tolerance below the
+// stored baseline and writes a JSON report either way. After timing, one more
+// episode per scenario runs with MemoryTelemetry and CounterTelemetry attached
+// so the report also shows allocations per tick phase, bytes per creature and
+// food, peak RSS and, where perf_event_open is permitted, cycles, IPC, cache
+// and branch misses per phase; --trace also records those episodes as a
+// Chrome trace. --compare-reorder N times each scenario again with creatures
+// reordered along a Morton curve every N ticks and reports the change in
+// ticks/s and cache misses; it is informational and never fails the gate.
+//
+//   CreatureSimPerfGate --baseline <file> [--report <file>] [--tolerance <fraction>]
+//                       [--budget <seconds>] [--update-baseline] [--trace <file>]
+//                       [--compare-reorder <ticks>]
+//
+// The baseline records the platform and compiler it was measured with; the
+// calibration loop does not cancel out allocator and codegen differences, so
+// a build that does not match them skips instead of comparing.
+//
+// CREATURE_SIM_PERF_TOLERANCE overrides the tolerance. Exit codes: 0 pass,
+// 1 regression, 2 usage or I/O error, 77 skipped (unoptimised build, or a
+// baseline from another platform or compiler).
+
+#include "SimEnvironment.h"
+#include "SimRandom.h"
+#include "SimTrace.h"
+#include "sim_scenario.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Scenario {
+    const char* name;
+    unsigned int seed;
+    int ticks;
+    int width;
+    int height;
+    double respawnMultiplier;
+    int herbivores;
+    int carnivores;
+};
+
+// Episodes are short so several fit in the budget; the fastest one counts.
+const Scenario kScenarios[] = {
+    { "grazers", 5, 400, 1280, 720, 3.0, 60, 0 },
+    { "predation", 7, 400, 1280, 720, 3.0, 60, 8 },
+    { "large_world", 11, 150, 2560, 1440, 8.0, 200, 10 },
+};
+
+double seconds(Clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+/**
+ * @brief Machine speed in calibration rounds per second.
+ *
+ * A round scores a block of random points by distance and picks the best one,
+ * roughly the mix of loads, square roots, divides and branches of a tick.
+ * The best of several short runs filters out scheduling noise.
+ */
+double calibrate()
+{
+    constexpr int kPoints = 4096;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    std::vector<double> xs(kPoints), ys(kPoints);
+    for (int i = 0; i < kPoints; ++i) {
+        xs[i] = coordinate(rng);
+        ys[i] = coordinate(rng);
+    }
+
+    double bestRate = 0.0;
+    volatile int sink = 0;
+    for (int run = 0; run < 5; ++run) {
+        int rounds = 0;
+        const Clock::time_point start = Clock::now();
+        Clock::duration elapsed{};
+        while (elapsed < std::chrono::milliseconds(60)) {
+            const double x = coordinate(rng);
+            const double y = coordinate(rng);
+            double best = -1.0;
+            int bestIndex = -1;
+            for (int i = 0; i < kPoints; ++i) {
+                const double dx = x - xs[i];
+                const double dy = y - ys[i];
+                const double score = 1.0 / std::max(1e-9, std::sqrt(dx * dx + dy * dy));
+                if (score > best) {
+                    best = score;
+                    bestIndex = i;
+                }
+            }
+            sink = sink + bestIndex;
+            rounds += 1;
+            elapsed = Clock::now() - start;
+        }
+        bestRate = std::max(bestRate, rounds / seconds(elapsed));
+    }
+    return bestRate;
+}
+
+/**
+ * @brief Wall time of one full episode of a scenario.
+ * @param telemetry Optional allocation telemetry for the episode.
+ * @param counters Optional performance counter telemetry for the episode.
+ * @param reorderInterval Ticks between spatial reorders of the creatures; 0 never reorders.
+ */
+double runEpisode(const Scenario& scenario, MemoryTelemetry* telemetry = nullptr,
+    CounterTelemetry* counters = nullptr, int reorderInterval = 0)
+{
+    SimRandom::seed(scenario.seed);
+
+    QVector<CreatureSettings> config = { SimScenario::herbivores(scenario.herbivores) };
+    if (scenario.carnivores > 0) {
+        config.push_back(SimScenario::carnivores(scenario.carnivores));
+    }
+
+    Environment environment = SimScenario::world(scenario.width, scenario.height, scenario.respawnMultiplier);
+    environment.memoryTelemetry = telemetry;
+    environment.counterTelemetry = counters;
+    environment.reorderInterval = reorderInterval;
+    SimScenario::populate(environment, config);
+
+    const Clock::time_point start = Clock::now();
+    SimScenario::run(environment, scenario.ticks);
+    return seconds(Clock::now() - start);
+}
+
+struct Measurement {
+    int episodes = 0;
+    double ticksPerSecond = 0.0;
+    double normalized = 0.0;
+};
+
+Measurement measure(const Scenario& scenario, double budget, double calibration, int reorderInterval = 0)
+{
+    Measurement result;
+    double fastest = 0.0;
+    const Clock::time_point start = Clock::now();
+    // At least three episodes, then as many as the budget allows.
+    while (result.episodes < 3 || seconds(Clock::now() - start) < budget) {
+        const double episode = runEpisode(scenario, nullptr, nullptr, reorderInterval);
+        fastest = result.episodes == 0 ? episode : std::min(fastest, episode);
+        result.episodes += 1;
+    }
+    result.ticksPerSecond = scenario.ticks / fastest;
+    // Ticks per thousand calibration rounds: independent of the machine's speed.
+    result.normalized = result.ticksPerSecond / calibration * 1000.0;
+    return result;
+}
+
+QJsonObject memoryToJson(const MemoryReport& memory)
+{
+    QJsonObject phases;
+    for (int phase = 0; phase < MemoryReport::PhaseCount; ++phase) {
+        QJsonObject entry;
+        entry["allocations"] = static_cast<double>(memory.phases[phase].allocations);
+        entry["bytes"] = static_cast<double>(memory.phases[phase].bytes);
+        phases[MemoryReport::phaseName(phase)] = entry;
+    }
+
+    QJsonObject obj;
+    obj["ticks"] = memory.ticks;
+    obj["phases"] = phases;
+    obj["allocationsPerTick"] = memory.total().allocations / static_cast<double>(std::max(1, memory.ticks));
+    obj["peakTickAllocations"] = static_cast<double>(memory.peakTickAllocations);
+    obj["peakTick"] = memory.peakTick;
+    obj["scratchPeakBytes"] = static_cast<double>(memory.scratchPeakBytes);
+    obj["peakCreatures"] = memory.peakCreatures;
+    obj["peakFood"] = memory.peakFood;
+    obj["bytesPerCreature"] = memory.bytesPerCreature;
+    obj["bytesPerFood"] = memory.bytesPerFood;
+    obj["peakResidentBytes"] = static_cast<double>(memory.peakResidentBytes);
+    return obj;
+}
+
+void printMemory(const MemoryReport& memory)
+{
+    std::printf("%12s allocations/tick", "");
+    for (int phase = 0; phase < MemoryReport::PhaseCount; ++phase) {
+        std::printf("  %s %.1f", MemoryReport::phaseName(phase),
+            memory.phases[phase].allocations / static_cast<double>(std::max(1, memory.ticks)));
+    }
+    std::printf("  (peak %llu on tick %d)\n", static_cast<unsigned long long>(memory.peakTickAllocations),
+        memory.peakTick);
+    std::printf("%12s %.0f B/creature  %.0f B/food  scratch peak %zu B  peak RSS %.1f MiB\n", "",
+        memory.bytesPerCreature, memory.bytesPerFood, memory.scratchPeakBytes,
+        memory.peakResidentBytes / 1024.0 / 1024.0);
+}
+
+QJsonObject countersToJson(const CounterReport& counters)
+{
+    QJsonObject obj;
+    if (!counters.unavailableReason.empty()) {
+        obj["unavailableReason"] = QString::fromStdString(counters.unavailableReason);
+    }
+    QJsonObject phases;
+    for (int phase = 0; phase < CounterReport::PhaseCount; ++phase) {
+        QJsonObject entry;
+        for (int counter = 0; counter < CounterValues::CounterCount; ++counter) {
+            if (counters.has(static_cast<CounterValues::Counter>(counter))) {
+                entry[CounterValues::counterName(counter)] = static_cast<double>(counters.phases[phase].values[counter]);
+            }
+        }
+        if (counters.has(CounterValues::Cycles) && counters.has(CounterValues::Instructions)) {
+            entry["ipc"] = counters.ipc(phase);
+        }
+        phases[CounterReport::phaseName(phase)] = entry;
+    }
+    obj["phases"] = phases;
+    return obj;
+}
+
+void printCounters(const CounterReport& counters)
+{
+    if (counters.available == 0) {
+        std::printf("%12s counters unavailable: %s\n", "", counters.unavailableReason.c_str());
+        return;
+    }
+    const double ticks = std::max(1, counters.ticks);
+    // The environment phases only; stats and render belong to the GUI worker.
+    for (int phase = 0; phase <= CounterReport::PhaseBirths; ++phase) {
+        const CounterValues& values = counters.phases[phase];
+        std::printf("%12s %-10s", "", CounterReport::phaseName(phase));
+        if (counters.has(CounterValues::Cycles)) {
+            std::printf("  %.0f cycles/tick  IPC %.2f  %.0f cache misses/tick  %.0f branch misses/tick",
+                values.values[CounterValues::Cycles] / ticks, counters.ipc(phase),
+                values.values[CounterValues::CacheMisses] / ticks, values.values[CounterValues::BranchMisses] / ticks);
+        }
+        if (counters.has(CounterValues::TaskClock)) {
+            std::printf("  %.1f us/tick  %.2f faults/tick", values.values[CounterValues::TaskClock] / ticks / 1000.0,
+                values.values[CounterValues::PageFaults] / ticks);
+        }
+        std::printf("\n");
+    }
+    if (!counters.unavailableReason.empty()) {
+        std::printf("%12s missing counters: %s\n", "", counters.unavailableReason.c_str());
+    }
+}
+
+/** @brief Cache misses per tick over the environment phases, or task time when misses are not counted. */
+double missesPerTick(const CounterReport& counters, CounterValues::Counter counter)
+{
+    std::uint64_t total = 0;
+    for (int phase = 0; phase <= CounterReport::PhaseBirths; ++phase) {
+        total += counters.phases[phase].values[counter];
+    }
+    return total / static_cast<double>(std::max(1, counters.ticks));
+}
+
+QJsonObject compareReorder(const Scenario& scenario, int interval, double budget, double calibration,
+    const Measurement& plain, const CounterReport& plainCounters)
+{
+    const Measurement reordered = measure(scenario, budget, calibration, interval);
+    CounterTelemetry counters;
+    runEpisode(scenario, nullptr, &counters, interval);
+    const CounterReport& report = counters.report();
+
+    QJsonObject obj;
+    obj["interval"] = interval;
+    obj["ticksPerSecond"] = reordered.ticksPerSecond;
+    obj["speedup"] = reordered.ticksPerSecond / plain.ticksPerSecond;
+    obj["counters"] = countersToJson(report);
+    std::printf("%12s reorder every %d: %.1f ticks/s (x%.2f)", "", interval, reordered.ticksPerSecond,
+        reordered.ticksPerSecond / plain.ticksPerSecond);
+    if (report.has(CounterValues::CacheMisses) && plainCounters.has(CounterValues::CacheMisses)) {
+        const double before = missesPerTick(plainCounters, CounterValues::CacheMisses);
+        const double after = missesPerTick(report, CounterValues::CacheMisses);
+        obj["cacheMissesPerTick"] = after;
+        obj["cacheMissReduction"] = before > 0.0 ? 1.0 - after / before : 0.0;
+        std::printf("  cache misses/tick %.0f -> %.0f", before, after);
+    } else if (report.has(CounterValues::TaskClock) && plainCounters.has(CounterValues::TaskClock)) {
+        std::printf("  task time %.1f -> %.1f us/tick (cache misses not counted)",
+            missesPerTick(plainCounters, CounterValues::TaskClock) / 1000.0,
+            missesPerTick(report, CounterValues::TaskClock) / 1000.0);
+    }
+    std::printf("\n");
+    return obj;
+}
+
+QString platformName()
+{
+#if defined(_WIN32)
+    return QStringLiteral("windows");
+#elif defined(__APPLE__)
+    return QStringLiteral("macos");
+#elif defined(__linux__)
+    return QStringLiteral("linux");
+#else
+    return QStringLiteral("other");
+#endif
+}
+
+QString compilerName()
+{
+#if defined(_MSC_VER)
+    return QStringLiteral("msvc %1").arg(_MSC_VER);
+#elif defined(__clang__)
+    return QStringLiteral("clang %1").arg(__clang_major__);
+#elif defined(__GNUC__)
+    return QStringLiteral("gcc %1").arg(__GNUC__);
+#else
+    return QStringLiteral("other");
+#endif
+}
+
+bool readJson(const QString& path, QJsonObject& object)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    object = document.object();
+    return document.isObject();
+}
+
+bool writeJson(const QString& path, const QJsonObject& object)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    QString baselinePath;
+    QString reportPath = QStringLiteral("perf_report.json");
+    QString tracePath;
+    double tolerance = 0.30;
+    double budget = 1.5;
+    int reorderInterval = 0;
+    bool updateBaseline = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = QString::fromUtf8(argv[++i]);
+        } else if (std::strcmp(argv[i], "--report") == 0 && hasValue) {
+            reportPath = QString::fromUtf8(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+            tolerance = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--budget") == 0 && hasValue) {
+            budget = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+            tracePath = QString::fromUtf8(argv[++i]);
+        } else if (std::strcmp(argv[i], "--compare-reorder") == 0 && hasValue) {
+            reorderInterval = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--update-baseline") == 0) {
+            updateBaseline = true;
+        } else {
+            std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (const char* value = std::getenv("CREATURE_SIM_PERF_TOLERANCE")) {
+        tolerance = std::atof(value);
+    }
+    if (baselinePath.isEmpty()) {
+        std::fprintf(stderr, "--baseline is required\n");
+        return 2;
+    }
+
+#ifndef NDEBUG
+    if (!updateBaseline) {
+        std::printf("skipped: throughput is only gated in optimised builds\n");
+        return 77;
+    }
+#endif
+
+    QJsonObject baselineScenarios;
+    if (!updateBaseline) {
+        QJsonObject baseline;
+        if (!readJson(baselinePath, baseline)) {
+            std::fprintf(stderr, "cannot read baseline %s\n", baselinePath.toStdString().c_str());
+            return 2;
+        }
+        const QString platform = baseline.value("platform").toString();
+        const QString compiler = baseline.value("compiler").toString();
+        if (platform != platformName() || compiler != compilerName()) {
+            std::printf("skipped: baseline was recorded on %s with %s, this build is %s with %s\n",
+                platform.toStdString().c_str(), compiler.toStdString().c_str(),
+                platformName().toStdString().c_str(), compilerName().toStdString().c_str());
+            return 77;
+        }
+        baselineScenarios = baseline.value("scenarios").toObject();
+    }
+
+    const double calibration = calibrate();
+    std::printf("calibration: %.0f rounds/s\n", calibration);
+
+    bool passed = true;
+    QJsonObject reportScenarios;
+    QJsonObject newBaseline;
+    for (const auto& scenario : kScenarios) {
+        const Measurement result = measure(scenario, budget, calibration);
+        const QString name = QString::fromUtf8(scenario.name);
+
+        QJsonObject entry;
+        entry["episodes"] = result.episodes;
+        entry["ticksPerSecond"] = result.ticksPerSecond;
+        entry["normalized"] = result.normalized;
+
+        QJsonObject baselineEntry;
+        baselineEntry["normalized"] = result.normalized;
+        newBaseline[name] = baselineEntry;
+
+        if (!updateBaseline) {
+            const double expected = baselineScenarios.value(name).toObject().value("normalized").toDouble(0.0);
+            const double ratio = expected > 0.0 ? result.normalized / expected : 1.0;
+            const bool ok = expected <= 0.0 || ratio >= 1.0 - tolerance;
+            entry["baseline"] = expected;
+            entry["ratio"] = ratio;
+            entry["passed"] = ok;
+            passed = passed && ok;
+            std::printf("%-12s %9.1f ticks/s  normalized %8.3f  baseline %8.3f  ratio %.2f  %s\n",
+                scenario.name, result.ticksPerSecond, result.normalized, expected, ratio,
+                ok ? "ok" : "REGRESSION");
+        } else {
+            std::printf("%-12s %9.1f ticks/s  normalized %8.3f\n",
+                scenario.name, result.ticksPerSecond, result.normalized);
+        }
+
+        MemoryTelemetry telemetry;
+        CounterTelemetry counters;
+        if (!tracePath.isEmpty()) {
+            SimTrace::start();
+        }
+        runEpisode(scenario, &telemetry, &counters);
+        SimTrace::stop();
+        telemetry.finish();
+        if (!tracePath.isEmpty()) {
+            const QString path = QString("%1.%2.json").arg(tracePath, name);
+            if (!SimTrace::writeChromeJson(path.toStdString())) {
+                std::fprintf(stderr, "cannot write trace %s\n", path.toStdString().c_str());
+            }
+        }
+        printMemory(telemetry.report());
+        printCounters(counters.report());
+        entry["memory"] = memoryToJson(telemetry.report());
+        entry["counters"] = countersToJson(counters.report());
+        if (reorderInterval > 0) {
+            entry["reorder"] = compareReorder(scenario, reorderInterval, budget, calibration, result,
+                counters.report());
+        }
+
+        reportScenarios[name] = entry;
+    }
+
+    QJsonObject report;
+    report["calibrationRoundsPerSecond"] = calibration;
+    report["tolerance"] = tolerance;
+    report["budgetSeconds"] = budget;
+    report["passed"] = passed;
+    report["scenarios"] = reportScenarios;
+    if (!writeJson(reportPath, report)) {
+        std::fprintf(stderr, "cannot write report %s\n", reportPath.toStdString().c_str());
+        return 2;
+    }
+
+    if (updateBaseline) {
+        QJsonObject baseline;
+        baseline["platform"] = platformName();
+        baseline["compiler"] = compilerName();
+        baseline["scenarios"] = newBaseline;
+        if (!writeJson(baselinePath, baseline)) {
+            std::fprintf(stderr, "cannot write baseline %s\n", baselinePath.toStdString().c_str());
+            return 2;
+        }
+        std::printf("baseline written to %s\n", baselinePath.toStdString().c_str());
+        return 0;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "SimEnvironment.h"
+
+/**
+ * @brief Building blocks for the seeded herbivore/carnivore worlds shared by the tests.
+ *
+ * Species come out with the default \c CreatureSettings apart from name, diet and
+ * population, so callers tweak only what their test is about.
+ */
+namespace SimScenario {
+/** @brief "Herbivore" species with \c population creatures. */
+inline CreatureSettings herbivores(int population)
+{
+    CreatureSettings settings;
+    settings.speciesName = "Herbivore";
+    settings.initialPopulation = population;
+    return settings;
+}
+
+/** @brief "Carnivore" species with \c population creatures. */
+inline CreatureSettings carnivores(int population)
+{
+    CreatureSettings settings;
+    settings.speciesName = "Carnivore";
+    settings.dietType = "carnivore";
+    settings.dietPreference = "Meat";
+    settings.initialPopulation = population;
+    return settings;
+}
+
+/** @brief "Omnivore" species with \c population creatures and the given food preference. */
+inline CreatureSettings omnivores(int population, const QString& preference = "Plants")
+{
+    CreatureSettings settings;
+    settings.speciesName = "Omnivore";
+    settings.dietType = "omnivore";
+    settings.dietPreference = preference;
+    settings.initialPopulation = population;
+    return settings;
+}
+
+/**
+ * @brief Environment with the tests' usual food settings: base 1, energy 15.
+ * @note Configure it before \c populate(); the setup reads the limits and strips.
+ */
+inline Environment world(int width, int height, double foodRespawnMultiplier = 3.0)
+{
+    return Environment(1.0, foodRespawnMultiplier, 15.0, width, height);
+}
+
+/** @brief Spawn the initial food and the creatures of \c config. */
+inline void populate(Environment& environment, const QVector<CreatureSettings>& config)
+{
+    environment.setupFood();
+    environment.setupCreatures(config);
+}
+
+/** @brief Advance \c ticks updates, calling \c afterTick with each tick's tracking. */
+template <typename AfterTick>
+void run(Environment& environment, int ticks, AfterTick&& afterTick)
+{
+    for (int i = 0; i < ticks; ++i) {
+        Tracking tracking(&environment.scratch);
+        environment.update(tracking);
+        afterTick(tracking);
+    }
+}
+
+/** @brief Advance \c ticks updates. */
+inline void run(Environment& environment, int ticks)
+{
+    run(environment, ticks, [](const Tracking&) {});
+}
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "SimChunks.h"
+#include "SimFood.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+TEST(ChunkGridTests, removeConsumedCompactsOnlyEatenFood)
+{
+    ChunkGrid grid;
+    grid.reset(512.0, 256.0, 256);
+    ASSERT_EQ(grid.chunks().size(), 2u);
+
+    Food left(1, 10.0, 10.0, 15.0);
+    Food eaten(2, 20.0, 10.0, 15.0);
+    Food right(3, 300.0, 10.0, 15.0);
+    grid.addFood(&left);
+    grid.addFood(&eaten);
+    grid.addFood(&right);
+
+    eaten.markConsumed();
+    grid.removeConsumed({ &eaten });
+
+    ASSERT_EQ(grid.chunks()[0].foods.size(), 1u);
+    EXPECT_EQ(grid.chunks()[0].foods[0], &left);
+    EXPECT_EQ(grid.chunks()[1].foods.size(), 1u);
+    EXPECT_EQ(grid.emptyCount(), 2);
+}
+
+TEST(ChunkGridTests, mortonKeysKeepEachChunkContiguous)
+{
+    ChunkGrid grid;
+    grid.reset(1024.0, 512.0, 256);
+
+    // Every key of a chunk lies in one range no other chunk's keys fall into.
+    std::vector<std::uint64_t> lowest(grid.chunks().size(), ~0ull);
+    std::vector<std::uint64_t> highest(grid.chunks().size(), 0);
+    for (double y = 0.5; y < 512.0; y += 8.0) {
+        for (double x = 0.5; x < 1024.0; x += 8.0) {
+            const int chunk = grid.chunkIndex(x, y);
+            const std::uint64_t key = grid.mortonKey(x, y);
+            lowest[chunk] = std::min(lowest[chunk], key);
+            highest[chunk] = std::max(highest[chunk], key);
+        }
+    }
+    for (std::size_t a = 0; a < lowest.size(); ++a) {
+        EXPECT_EQ(highest[a] - lowest[a], 255u);
+        for (std::size_t b = a + 1; b < lowest.size(); ++b) {
+            EXPECT_TRUE(highest[a] < lowest[b] || highest[b] < lowest[a]) << a << " overlaps " << b;
+        }
+    }
+
+    EXPECT_EQ(grid.mortonKey(-10.0, -10.0), 0u);
+    EXPECT_EQ(grid.mortonKey(5000.0, 5000.0), grid.mortonKey(1023.9, 511.9));
+}
+
+TEST(ChunkGridTests, chunksNearClampsToTheGrid)
+{
+    ChunkGrid grid;
+    grid.reset(1000.0, 500.0, 256);
+
+    const ChunkGrid::Range inside = grid.chunksNear(300.0, 300.0, 50.0);
+    EXPECT_EQ(inside.firstColumn, 0);
+    EXPECT_EQ(inside.lastColumn, 1);
+    EXPECT_EQ(inside.firstRow, 0);
+    EXPECT_EQ(inside.lastRow, 1);
+
+    const ChunkGrid::Range edge = grid.chunksNear(990.0, 10.0, 100.0);
+    EXPECT_EQ(edge.firstColumn, 3);
+    EXPECT_EQ(edge.lastColumn, 3);
+    EXPECT_EQ(edge.firstRow, 0);
+    EXPECT_EQ(edge.lastRow, 0);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "SimCounters.h"
+#include "SimEnvironment.h"
+#include "SimRandom.h"
+#include "sim_scenario.h"
+
+TEST(CounterTelemetryTests, differencesNeverWrap)
+{
+    CounterValues earlier;
+    CounterValues later;
+    earlier.values[CounterValues::Cycles] = 10;
+    later.values[CounterValues::Cycles] = 4;
+    later.values[CounterValues::Instructions] = 8;
+
+    const CounterValues delta = later - earlier;
+    EXPECT_EQ(delta.values[CounterValues::Cycles], 0u);
+    EXPECT_EQ(delta.values[CounterValues::Instructions], 8u);
+}
+
+TEST(CounterTelemetryTests, ipcNeedsCyclesAndInstructions)
+{
+    CounterReport report;
+    report.phases[CounterReport::PhaseFood].values[CounterValues::Cycles] = 200;
+    report.phases[CounterReport::PhaseFood].values[CounterValues::Instructions] = 300;
+    EXPECT_EQ(report.ipc(CounterReport::PhaseFood), 0.0);
+
+    report.available = (1u << CounterValues::Cycles) | (1u << CounterValues::Instructions);
+    EXPECT_DOUBLE_EQ(report.ipc(CounterReport::PhaseFood), 1.5);
+    EXPECT_EQ(report.ipc(CounterReport::PhaseRender), 0.0);
+}
+
+TEST(CounterTelemetryTests, environmentDegradesWhenCountersAreMissing)
+{
+    SimRandom::seed(9);
+    CounterTelemetry telemetry;
+    Environment environment = SimScenario::world(640, 360);
+    environment.counterTelemetry = &telemetry;
+    SimScenario::populate(environment, { SimScenario::herbivores(30) });
+    SimScenario::run(environment, 20);
+
+    const CounterReport& report = telemetry.report();
+    EXPECT_TRUE(report.enabled);
+    EXPECT_EQ(report.ticks, 20);
+    constexpr unsigned all = (1u << CounterValues::CounterCount) - 1;
+    if (report.available != all) {
+        // Containers and VMs often refuse some or all counters; the run still completes.
+        EXPECT_FALSE(report.unavailableReason.empty());
+    }
+    if (report.has(CounterValues::TaskClock)) {
+        EXPECT_GT(report.phases[CounterReport::PhaseCreatures].values[CounterValues::TaskClock], 0u);
+    }
+    if (report.has(CounterValues::Instructions)) {
+        EXPECT_GT(report.phases[CounterReport::PhaseCreatures].values[CounterValues::Instructions], 0u);
+    }
+}
@@ -0,0 +1,319 @@
+#include <gtest/gtest.h>
+#include "SimBehavior.h"
+#include "SimEnvironment.h"
+#include "SimRandom.h"
+#include "sim_scenario.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+TEST(EnvironmentTests, foodCompetitionMatchesCreatureTargets)
+{
+    SimRandom::seed(7);
+    Environment environment = SimScenario::world(640, 360);
+    SimScenario::populate(environment, { SimScenario::herbivores(40), SimScenario::omnivores(10) });
+
+    for (int i = 0; i < 600; ++i) {
+        Tracking tracking(&environment.scratch);
+        environment.update(tracking);
+
+        std::vector<int> expected(environment.foods.size(), 0);
+        for (auto* creature : environment.creatures) {
+            if (creature->targetFood.type == TargetRef::Type::Food) {
+                expected[creature->targetFood.food->storageIndex()] += 1;
+            }
+        }
+        ASSERT_EQ(environment.foodCompetitors, expected) << "tick " << environment.tick;
+    }
+}
+
+TEST(EnvironmentTests, duplicateSpeciesNamesMustAgree)
+{
+    QVector<CreatureSettings> config;
+    CreatureSettings herbivore;
+    herbivore.speciesName = "Herbivore";
+    config.push_back(herbivore);
+    CreatureSettings grazer = herbivore;
+    grazer.initialPopulation = 3;
+    config.push_back(grazer);
+    // Per-creature traits may differ between configs of one species.
+    EXPECT_TRUE(Environment::speciesConflict(config).isEmpty());
+
+    config[1].dietType = "carnivore";
+    const QString conflict = Environment::speciesConflict(config);
+    EXPECT_FALSE(conflict.isEmpty());
+    EXPECT_TRUE(conflict.contains("diet"));
+
+    config[1].dietType = herbivore.dietType;
+    config[1].speciesName = "Grazer";
+    config[1].colorR = herbivore.colorR + 1;
+    EXPECT_TRUE(Environment::speciesConflict(config).isEmpty());
+}
+
+TEST(EnvironmentTests, stopFlagSkipsRemainingCreatures)
+{
+    Environment environment = SimScenario::world(640, 360, 1.0);
+    environment.setupCreatures({ SimScenario::herbivores(5) });
+
+    std::atomic_bool stop{ true };
+    environment.stopFlag = &stop;
+    Tracking tracking(&environment.scratch);
+    environment.update(tracking);
+
+    EXPECT_TRUE(environment.interrupted);
+    for (auto* creature : environment.creatures) {
+        EXPECT_EQ(creature->age, 0.0);
+    }
+
+    stop = false;
+    Tracking next(&environment.scratch);
+    environment.update(next);
+    EXPECT_FALSE(environment.interrupted);
+    EXPECT_GT(environment.creatures.front()->age, 0.0);
+}
+
+static std::vector<int> runStrips(int threads)
+{
+    SimRandom::seed(11);
+    Environment environment = SimScenario::world(1280, 360);
+    environment.stripCount = 4;
+    environment.stripThreads = threads;
+    environment.perceptionRadius = 100.0;
+    SimScenario::populate(environment, { SimScenario::herbivores(80), SimScenario::carnivores(10) });
+
+    std::vector<int> trace;
+    SimScenario::run(environment, 400, [&](const Tracking&) {
+        EXPECT_EQ(environment.activeStrips, 4);
+        trace.push_back(static_cast<int>(environment.creatures.size()));
+        trace.push_back(static_cast<int>(environment.foods.size()));
+        trace.push_back(environment.creatureID);
+    });
+    return trace;
+}
+
+TEST(EnvironmentTests, stripUpdatesDoNotDependOnThreadCount)
+{
+    const std::vector<int> single = runStrips(1);
+    EXPECT_EQ(runStrips(4), single);
+    EXPECT_EQ(runStrips(2), single);
+}
+
+static QVector<CreatureSettings> fastBreeders()
+{
+    QVector<CreatureSettings> config;
+    CreatureSettings breeder = SimScenario::herbivores(40);
+    breeder.speciesName = "Breeder";
+    breeder.litterSize = 8;
+    breeder.reproductionCost = 5;
+    breeder.matingHungerThreshold = 10;
+    breeder.reproductionCooldown = 5;
+    config.push_back(breeder);
+    return config;
+}
+
+TEST(EnvironmentTests, creatureBudgetRefusesBirthsBeforeAllocating)
+{
+    SimRandom::seed(3);
+    Environment environment = SimScenario::world(640, 360, 20.0);
+    environment.budget.maxCreatures = 120;
+    SimScenario::populate(environment, fastBreeders());
+
+    bool hit = false;
+    for (int i = 0; i < 300; ++i) {
+        Tracking tracking(&environment.scratch);
+        environment.update(tracking);
+        ASSERT_LE(environment.creatures.size(), 120u) << "tick " << environment.tick;
+        if (environment.budgetHits & PopulationBudget::LimitCreatures) {
+            hit = true;
+            EXPECT_GT(environment.birthsRefused, 0);
+        }
+    }
+    EXPECT_TRUE(hit);
+    EXPECT_STREQ(PopulationBudget::limitName(PopulationBudget::LimitCreatures | PopulationBudget::LimitMemory),
+        "creatureBudget");
+}
+
+static std::vector<int> runSuppressed(int threads)
+{
+    SimRandom::seed(5);
+    Environment environment = SimScenario::world(1280, 360, 20.0);
+    environment.budget.maxCreatures = 200;
+    environment.budget.mode = PopulationBudget::SuppressBirths;
+    environment.stripCount = 4;
+    environment.stripThreads = threads;
+    environment.perceptionRadius = 100.0;
+    SimScenario::populate(environment, fastBreeders());
+
+    std::vector<int> trace;
+    SimScenario::run(environment, 300, [&](const Tracking&) {
+        EXPECT_LE(environment.creatures.size(), 200u);
+        trace.push_back(static_cast<int>(environment.creatures.size()));
+        trace.push_back(environment.birthsRefused);
+    });
+    return trace;
+}
+
+TEST(EnvironmentTests, birthSuppressionIsDeterministicAcrossStrips)
+{
+    const std::vector<int> single = runSuppressed(1);
+    EXPECT_EQ(runSuppressed(4), single);
+
+    int refused = 0;
+    for (std::size_t i = 1; i < single.size(); i += 2) {
+        refused += single[i];
+    }
+    EXPECT_GT(refused, 0);
+}
+
+TEST(EnvironmentTests, memoryBudgetLimitsFood)
+{
+    SimRandom::seed(2);
+    Environment environment(10.0, 10.0, 15.0, 640, 360);
+    environment.budget.maxBytes = 64 * 1024;
+    environment.setupFood();
+
+    unsigned hits = environment.budgetHits;
+    for (int i = 0; i < 200; ++i) {
+        Tracking tracking(&environment.scratch);
+        environment.update(tracking);
+        hits |= environment.budgetHits;
+        const MemoryTelemetry::Footprint used = environment.footprint();
+        ASSERT_LE(used.creatureBytes + used.foodBytes, environment.budget.maxBytes) << "tick " << environment.tick;
+    }
+    EXPECT_GT(environment.foods.size(), 0u);
+    EXPECT_EQ(hits, static_cast<unsigned>(PopulationBudget::LimitMemory));
+}
+
+TEST(EnvironmentTests, reorderSortsCreaturesAndRedirectsTargets)
+{
+    SimRandom::seed(13);
+    Environment environment = SimScenario::world(1280, 720);
+    SimScenario::populate(environment, { SimScenario::herbivores(60), SimScenario::carnivores(10) });
+    SimScenario::run(environment, 50);
+    ASSERT_GT(environment.creatureDisorder(), 0.2);
+
+    std::vector<int> preyOf;
+    std::vector<int> ids;
+    for (auto* creature : environment.creatures) {
+        ids.push_back(creature->id);
+        preyOf.push_back(creature->targetFood.type == TargetRef::Type::Creature ? creature->targetFood.creature->id : 0);
+    }
+
+    environment.reorderCreatures();
+    EXPECT_EQ(environment.creatureDisorder(), 0.0);
+    EXPECT_EQ(environment.reorders, 1);
+    for (std::size_t i = 1; i < environment.creatures.size(); ++i) {
+        // Contiguous block in update order.
+        EXPECT_EQ(environment.creatures[i], environment.creatures[i - 1] + 1);
+    }
+    for (auto* creature : environment.creatures) {
+        const auto at = std::find(ids.begin(), ids.end(), creature->id);
+        ASSERT_NE(at, ids.end());
+        const int prey = preyOf[at - ids.begin()];
+        if (prey != 0) {
+            ASSERT_EQ(creature->targetFood.type, TargetRef::Type::Creature);
+            EXPECT_EQ(creature->targetFood.creature->id, prey);
+            EXPECT_NE(std::find(environment.creatures.begin(), environment.creatures.end(), creature->targetFood.creature),
+                environment.creatures.end());
+        }
+    }
+    EXPECT_EQ(environment.creatures.size(), ids.size());
+
+    // Keeps running on the relocated creatures, including deaths inside the block.
+    SimScenario::run(environment, 100);
+}
+
+static std::vector<int> runReordered(int threads)
+{
+    SimRandom::seed(17);
+    Environment environment = SimScenario::world(1280, 360);
+    environment.stripCount = 4;
+    environment.stripThreads = threads;
+    environment.perceptionRadius = 100.0;
+    environment.reorderInterval = 25;
+    environment.reorderDisorder = 0.3;
+    SimScenario::populate(environment, { SimScenario::herbivores(80) });
+
+    std::vector<int> trace;
+    SimScenario::run(environment, 300, [&](const Tracking&) {
+        trace.push_back(static_cast<int>(environment.creatures.size()));
+        trace.push_back(environment.creatures.empty() ? 0 : environment.creatures.front()->id);
+    });
+    trace.push_back(environment.reorders);
+    return trace;
+}
+
+TEST(EnvironmentTests, reorderedRunsAreDeterministic)
+{
+    const std::vector<int> single = runReordered(1);
+    EXPECT_EQ(runReordered(1), single);
+    EXPECT_EQ(runReordered(4), single);
+    EXPECT_GE(single.back(), 300 / 25);
+}
+
+TEST(EnvironmentTests, boundedPerceptionMatchesFullScan)
+{
+    SimRandom::seed(19);
+    Environment environment = SimScenario::world(1280, 720);
+    environment.sensingRadius = 90.0;
+    SimScenario::populate(environment, { SimScenario::herbivores(80), SimScenario::omnivores(20) });
+    SimScenario::run(environment, 200);
+    ASSERT_FALSE(environment.creatures.empty());
+    // List the survivors, as the next update would.
+    environment.chunks.countCreatures(environment.creatures, true);
+
+    auto distance = [](const Creature& a, const Creature& b) { return std::hypot(a.x - b.x, a.y - b.y); };
+    int threats = 0;
+    int mates = 0;
+    int prey = 0;
+    for (auto* creature : environment.creatures) {
+        environment.sensingRadius = 90.0;
+        const CreatureBehaviour::Neighborhood bounded = CreatureBehaviour::perceive(*creature, environment);
+
+        const Creature* threat = nullptr;
+        double closest = std::numeric_limits<double>::infinity();
+        for (auto* other : environment.creatures) {
+            const double d = distance(*creature, *other);
+            if (other->species != creature->species && other->species->diet != Diet::Herbivore && d <= 90.0 && d < closest) {
+                closest = d;
+                threat = other;
+            }
+        }
+        EXPECT_EQ(bounded.threat, threat);
+        threats += bounded.threat != nullptr;
+        mates += bounded.mate != nullptr;
+        prey += bounded.prey != nullptr;
+        if (bounded.mate) {
+            EXPECT_LE(distance(*creature, *bounded.mate), 90.0);
+        }
+        if (bounded.prey) {
+            EXPECT_LE(distance(*creature, *bounded.prey), 90.0);
+        }
+        if (bounded.food) {
+            EXPECT_LE(std::hypot(creature->x - bounded.food->x(), creature->y - bounded.food->y()), 90.0);
+        }
+
+        // A radius covering the world senses what the full scan does.
+        environment.sensingRadius = 2000.0;
+        const CreatureBehaviour::Neighborhood everything = CreatureBehaviour::perceive(*creature, environment);
+        environment.sensingRadius = 0.0;
+        const CreatureBehaviour::Neighborhood full = CreatureBehaviour::perceive(*creature, environment);
+        EXPECT_EQ(everything.threat, full.threat);
+        EXPECT_EQ(everything.mate, full.mate);
+        EXPECT_EQ(everything.prey, full.prey);
+        EXPECT_EQ(everything.preyScore, full.preyScore);
+        EXPECT_EQ(everything.food, full.food);
+        if (full.food) {
+            EXPECT_DOUBLE_EQ(everything.foodScore, full.foodScore);
+        }
+    }
+
+    EXPECT_GT(threats, 0);
+    EXPECT_GT(mates, 0);
+    EXPECT_GT(prey, 0);
+
+    environment.sensingRadius = 90.0;
+    SimScenario::run(environment, 100);
+}
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include "SimFood.h"
+
+#include <memory>
+
+TEST(FoodExpiryWheelTests, expiresOnLifetimeTick)
+{
+    FoodExpiryWheel wheel;
+    std::vector<std::unique_ptr<Food>> foods;
+    std::vector<Food*> expired;
+
+    for (int tick = 0; tick < 3 * Food::kLifetime; tick++) {
+        wheel.expire(tick, expired);
+        for (auto* food : expired) {
+            EXPECT_EQ(food->expiryTick(), tick);
+            EXPECT_EQ(food->id(), tick - Food::kLifetime);
+            EXPECT_TRUE(food->consumed());
+        }
+        expired.clear();
+
+        foods.push_back(std::make_unique<Food>(tick, 0.0, 0.0, 15.0));
+        wheel.schedule(foods.back().get(), tick);
+    }
+}
+
+TEST(FoodExpiryWheelTests, cancelledFoodNeverExpires)
+{
+    FoodExpiryWheel wheel;
+    Food kept(1, 0.0, 0.0, 15.0);
+    Food eaten(2, 0.0, 0.0, 15.0);
+    wheel.schedule(&kept, 0);
+    wheel.schedule(&eaten, 0);
+    wheel.cancel(&eaten);
+    wheel.cancel(&eaten);
+
+    std::vector<Food*> expired;
+    wheel.expire(Food::kLifetime, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], &kept);
+    EXPECT_FALSE(eaten.consumed());
+}
@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+#include "SimEnvironment.h"
+#include "SimRandom.h"
+#include "sim_scenario.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Golden runs: fixed-seed scenarios whose full world state is hashed every
+// kHashTicks ticks, with per-entity hashes every kEntityTicks ticks, and
+// compared against tests/golden/<scenario>.golden.
+//
+// After an intended behaviour change, regenerate the files with
+//   CREATURE_SIM_UPDATE_GOLDEN=1 ctest -L golden
+// and commit them together with the change.
+//
+// The hashes cover raw double bits, so they hold for the default double build
+// with IEEE double arithmetic and no fused multiply-add contraction (x86-64).
+
+#ifndef CREATURE_SIM_GOLDEN_DIR
+#define CREATURE_SIM_GOLDEN_DIR "tests/golden"
+#endif
+
+namespace {
+
+constexpr int kHashTicks = 10;
+constexpr int kEntityTicks = 50;
+
+struct Scenario {
+    const char* name;
+    unsigned int seed;
+    int ticks;
+    int width;
+    int height;
+    int herbivores;
+    int carnivores;
+    int omnivores;
+    int lodInterval;
+    int stripCount;
+};
+
+void PrintTo(const Scenario& scenario, std::ostream* out)
+{
+    *out << scenario.name;
+}
+
+const Scenario kScenarios[] = {
+    { "grazers", 17, 600, 640, 360, 40, 0, 0, 1, 1 },
+    { "predation", 23, 600, 960, 540, 40, 6, 6, 1, 1 },
+    { "lod_strips", 31, 450, 1280, 360, 60, 6, 0, 4, 4 },
+};
+
+class Hasher {
+public:
+    template <typename T>
+    void add(const T& value)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (unsigned char byte : bytes) {
+            m_hash = (m_hash ^ byte) * 1099511628211ull;
+        }
+    }
+
+    std::uint64_t value() const { return m_hash; }
+
+private:
+    std::uint64_t m_hash = 1469598103934665603ull;
+};
+
+std::uint64_t hashCreature(const Creature& creature)
+{
+    Hasher hasher;
+    hasher.add(creature.id);
+    hasher.add(creature.species->index);
+    hasher.add(static_cast<double>(creature.x));
+    hasher.add(static_cast<double>(creature.y));
+    hasher.add(static_cast<double>(creature.baseSpeed));
+    hasher.add(static_cast<double>(creature.speedMultiplier));
+    hasher.add(creature.metabolicRate);
+    hasher.add(static_cast<double>(creature.fullnessLevel));
+    hasher.add(creature.fullnessCap);
+    hasher.add(static_cast<double>(creature.reserveEnergy));
+    hasher.add(creature.reproductionCooldown);
+    hasher.add(creature.litterSize);
+    hasher.add(creature.size);
+    hasher.add(creature.health);
+    hasher.add(creature.age);
+    hasher.add(creature.attackPower);
+    hasher.add(creature.defencePower);
+    hasher.add(static_cast<int>(creature.state));
+    hasher.add(creature.dead);
+    hasher.add(creature.tired);
+    hasher.add(creature.recoveryNeeded);
+    hasher.add(static_cast<int>(creature.targetFood.type));
+    hasher.add(creature.targetFood.id());
+    hasher.add(creature.fleeCount);
+    hasher.add(creature.hasLastDirection);
+    hasher.add(creature.lastDirection.x);
+    hasher.add(creature.lastDirection.y);
+    hasher.add(creature.lodSleep);
+    hasher.add(creature.lodPending);
+    return hasher.value();
+}
+
+std::uint64_t hashFood(const Food& food)
+{
+    Hasher hasher;
+    hasher.add(food.id());
+    hasher.add(food.x());
+    hasher.add(food.y());
+    hasher.add(food.energyContent());
+    hasher.add(food.consumed());
+    hasher.add(food.expiryTick());
+    return hasher.value();
+}
+
+/**
+ * @brief Hashes of one checkpoint: the whole world and, on entity ticks, each
+ *        entity keyed "c <id>" / "f <id>".
+ */
+struct Checkpoint {
+    std::uint64_t world = 0;
+    int entityCount = 0;
+    std::vector<std::pair<std::string, std::uint64_t>> entities;
+};
+
+Checkpoint capture(const Environment& environment, bool withEntities)
+{
+    Checkpoint checkpoint;
+    Hasher world;
+    world.add(environment.tick);
+    world.add(environment.creatureID);
+    world.add(environment.foodID);
+    for (const auto* creature : environment.creatures) {
+        const std::uint64_t hash = hashCreature(*creature);
+        world.add(hash);
+        checkpoint.entities.emplace_back("c " + std::to_string(creature->id), hash);
+    }
+    for (const auto* food : environment.foods) {
+        const std::uint64_t hash = hashFood(*food);
+        world.add(hash);
+        checkpoint.entities.emplace_back("f " + std::to_string(food->id()), hash);
+    }
+    checkpoint.world = world.value();
+    checkpoint.entityCount = static_cast<int>(checkpoint.entities.size());
+    if (!withEntities) {
+        checkpoint.entities.clear();
+    }
+    return checkpoint;
+}
+
+std::map<int, Checkpoint> runScenario(const Scenario& scenario)
+{
+    SimRandom::seed(scenario.seed);
+
+    QVector<CreatureSettings> config = { SimScenario::herbivores(scenario.herbivores) };
+    if (scenario.carnivores > 0) {
+        config.push_back(SimScenario::carnivores(scenario.carnivores));
+    }
+    if (scenario.omnivores > 0) {
+        config.push_back(SimScenario::omnivores(scenario.omnivores, "Meat"));
+    }
+
+    Environment environment = SimScenario::world(scenario.width, scenario.height);
+    environment.lodInterval = scenario.lodInterval;
+    environment.stripCount = scenario.stripCount;
+    environment.stripThreads = 2;
+    environment.perceptionRadius = 100.0;
+    SimScenario::populate(environment, config);
+
+    std::map<int, Checkpoint> checkpoints;
+    checkpoints[0] = capture(environment, true);
+    for (int i = 1; i <= scenario.ticks; ++i) {
+        Tracking tracking(&environment.scratch);
+        environment.update(tracking);
+        if (i % kHashTicks == 0) {
+            checkpoints[i] = capture(environment, i % kEntityTicks == 0);
+        }
+    }
+    return checkpoints;
+}
+
+std::string goldenPath(const Scenario& scenario)
+{
+    return std::string(CREATURE_SIM_GOLDEN_DIR) + "/" + scenario.name + ".golden";
+}
+
+std::string hex(std::uint64_t value)
+{
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+    return text;
+}
+
+bool writeGolden(const std::string& path, const std::map<int, Checkpoint>& checkpoints)
+{
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    for (const auto& [tick, checkpoint] : checkpoints) {
+        out << "tick " << tick << ' ' << hex(checkpoint.world) << ' ' << checkpoint.entityCount << '\n';
+        for (const auto& [key, hash] : checkpoint.entities) {
+            out << key << ' ' << hex(hash) << '\n';
+        }
+    }
+    return true;
+}
+
+bool readGolden(const std::string& path, std::map<int, Checkpoint>& checkpoints)
+{
+    std::ifstream in(path);
+    std::string line;
+    Checkpoint* current = nullptr;
+    while (std::getline(in, line)) {
+        std::istringstream row(line);
+        std::string kind;
+        row >> kind;
+        if (kind == "tick") {
+            int tick = 0;
+            std::string world;
+            row >> tick >> world >> checkpoints[tick].entityCount;
+            current = &checkpoints[tick];
+            current->world = std::stoull(world, nullptr, 16);
+        } else if (current && (kind == "c" || kind == "f")) {
+            std::string id, hash;
+            row >> id >> hash;
+            current->entities.emplace_back(kind + " " + id, std::stoull(hash, nullptr, 16));
+        }
+    }
+    return !checkpoints.empty();
+}
+
+/** @brief Describe the first entity that differs between two checkpoints. */
+std::string firstDifference(const Checkpoint& expected, const Checkpoint& actual)
+{
+    std::map<std::string, std::uint64_t> actualByKey(actual.entities.begin(), actual.entities.end());
+    for (const auto& [key, hash] : expected.entities) {
+        const auto found = actualByKey.find(key);
+        if (found == actualByKey.end()) {
+            return key + " is missing";
+        }
+        if (found->second != hash) {
+            return key + " differs";
+        }
+    }
+    std::map<std::string, std::uint64_t> expectedByKey(expected.entities.begin(), expected.entities.end());
+    for (const auto& [key, hash] : actual.entities) {
+        if (!expectedByKey.count(key)) {
+            return key + " is unexpected";
+        }
+    }
+    return "entity order differs";
+}
+
+class GoldenRunTests : public ::testing::TestWithParam<Scenario> {
+};
+
+}
+
+TEST_P(GoldenRunTests, matchesGoldenFile)
+{
+#ifdef CREATURE_SIM_FLOAT_STATE
+    GTEST_SKIP() << "golden files are recorded with double state";
+#endif
+    const Scenario& scenario = GetParam();
+    const std::map<int, Checkpoint> actual = runScenario(scenario);
+    const std::string path = goldenPath(scenario);
+
+    if (std::getenv("CREATURE_SIM_UPDATE_GOLDEN")) {
+        ASSERT_TRUE(writeGolden(path, actual)) << "cannot write " << path;
+        GTEST_SKIP() << "updated " << path;
+    }
+
+    std::map<int, Checkpoint> expected;
+    ASSERT_TRUE(readGolden(path, expected)) << "missing golden file " << path;
+
+    int divergedAt = -1;
+    for (const auto& [tick, checkpoint] : expected) {
+        const auto found = actual.find(tick);
+        ASSERT_NE(found, actual.end()) << "run has no checkpoint at tick " << tick;
+        if (divergedAt < 0 && found->second.world != checkpoint.world) {
+            divergedAt = tick;
+        }
+        // Name the first differing entity at the first entity checkpoint from there on.
+        if (divergedAt >= 0 && !checkpoint.entities.empty()) {
+            FAIL() << scenario.name << ": world state diverges between ticks " << divergedAt - kHashTicks
+                   << " and " << divergedAt << " (" << found->second.entityCount << " entities, expected "
+                   << checkpoint.entityCount << "); at tick " << tick << ' '
+                   << firstDifference(checkpoint, found->second);
+        }
+    }
+    if (divergedAt >= 0) {
+        FAIL() << scenario.name << ": world state diverges between ticks " << divergedAt - kHashTicks
+               << " and " << divergedAt;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Scenarios, GoldenRunTests, ::testing::ValuesIn(kScenarios),
+    [](const ::testing::TestParamInfo<Scenario>& info) { return std::string(info.param.name); });
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "SimBehavior.h"
+#include "SimEnvironment.h"
+#include "SimRandom.h"
+#include "sim_scenario.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace {
+struct RunSummary {
+    double meanHerbivores = 0.0;
+    double meanCarnivores = 0.0;
+};
+
+RunSummary runScenario(unsigned int seed, int lodInterval, int ticks)
+{
+    SimRandom::seed(seed);
+    Environment environment = SimScenario::world(1280, 720);
+    environment.lodInterval = lodInterval;
+    SimScenario::populate(environment, { SimScenario::herbivores(60), SimScenario::carnivores(8) });
+
+    RunSummary summary;
+    SimScenario::run(environment, ticks, [&](const Tracking&) {
+        summary.meanHerbivores += environment.traits.population(0);
+        summary.meanCarnivores += environment.traits.population(1);
+    });
+    summary.meanHerbivores /= ticks;
+    summary.meanCarnivores /= ticks;
+    return summary;
+}
+}
+
+TEST(LodSchedulingTests, populationStaysCloseToFullRate)
+{
+    constexpr int kSeeds = 4;
+    constexpr int kTicks = 1000;
+
+    RunSummary full;
+    RunSummary lod;
+    for (unsigned int seed = 1; seed <= kSeeds; ++seed) {
+        const RunSummary a = runScenario(seed, 1, kTicks);
+        const RunSummary b = runScenario(seed, 8, kTicks);
+        full.meanHerbivores += a.meanHerbivores / kSeeds;
+        full.meanCarnivores += a.meanCarnivores / kSeeds;
+        lod.meanHerbivores += b.meanHerbivores / kSeeds;
+        lod.meanCarnivores += b.meanCarnivores / kSeeds;
+    }
+
+    const double herbivoreDivergence = std::abs(lod.meanHerbivores - full.meanHerbivores) / full.meanHerbivores;
+    const double carnivoreDivergence = std::abs(lod.meanCarnivores - full.meanCarnivores) / full.meanCarnivores;
+    RecordProperty("herbivoreDivergence", std::to_string(herbivoreDivergence));
+    RecordProperty("carnivoreDivergence", std::to_string(carnivoreDivergence));
+
+    // Measured at 0 for these seeds; the idle tier replays the skipped ticks.
+    EXPECT_LT(herbivoreDivergence, 0.02);
+    EXPECT_LT(carnivoreDivergence, 0.02);
+}
+
+TEST(LodSchedulingTests, unsensedPredatorBeyondTheRadiusKeepsRestersAwake)
+{
+    Environment environment = SimScenario::world(1280, 720);
+    environment.lodInterval = 8;
+    environment.setupCreatures({ SimScenario::herbivores(1), SimScenario::carnivores(1) });
+    ASSERT_EQ(environment.creatures.size(), 2u);
+    Creature& rester = *environment.creatures[0];
+    Creature& hunter = *environment.creatures[1];
+    environment.maxCreatureSpeed = std::max(rester.effectiveSpeed, hunter.effectiveSpeed);
+    const double reach = rester.effectiveSpeed * rester.skittishMultiplierScared
+        + 2.0 * (environment.maxCreatureSpeed + rester.effectiveSpeed) * environment.lodInterval;
+
+    auto intervalWithHunterAt = [&](double distance, double radius) {
+        rester.x = 100.0;
+        rester.y = 360.0;
+        hunter.x = rester.x + distance;
+        hunter.y = rester.y;
+        environment.sensingRadius = radius;
+        environment.chunks.countCreatures(environment.creatures, true);
+        CreatureBehaviour::checkSafety(rester, CreatureBehaviour::perceive(rester, environment));
+        rester.state = CreatureState::Resting;
+        rester.tired = true;
+        rester.recoveryNeeded = 60;
+        return CreatureBehaviour::updateInterval(rester, environment);
+    };
+
+    // The hunter is out of sight but close enough to arrive within the interval.
+    const double radius = reach / 2.0;
+    EXPECT_EQ(intervalWithHunterAt(radius + 1.0, radius), 1);
+    EXPECT_EQ(rester.threatDistance, std::numeric_limits<double>::infinity());
+    // Sensing everything, the same hunter is seen and still keeps the creature awake.
+    EXPECT_EQ(intervalWithHunterAt(radius + 1.0, 0.0), 1);
+    // Far away, both a full scan and a radius covering the reach allow sleeping.
+    EXPECT_EQ(intervalWithHunterAt(reach + 10.0, 0.0), 8);
+    EXPECT_EQ(intervalWithHunterAt(reach + 10.0, reach + 5.0), 8);
+}
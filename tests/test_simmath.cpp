@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "SimMath.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+TEST(SimMathTests, unitVectorMatchesReference)
+{
+    // Measured against long double so the host libm is not what gets tested. The two-ulp
+    // bound (measured worst case 0.74) leaves room for runtimes where long double is double.
+    const long double tolerance = 2.0L * std::numeric_limits<double>::epsilon();
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> angles(-7.0, 7.0);
+    for (int i = 0; i < 200000; ++i) {
+        const double angle = angles(rng);
+        const Heading heading = SimMath::unitVector(angle);
+        ASSERT_LE(std::fabs(heading.x - std::cos(static_cast<long double>(angle))), tolerance) << angle;
+        ASSERT_LE(std::fabs(heading.y - std::sin(static_cast<long double>(angle))), tolerance) << angle;
+    }
+}
+
+TEST(SimMathTests, rotationTracksAccumulatedAngle)
+{
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> turns(-0.32, 0.32);
+    Heading heading = SimMath::unitVector(1.0);
+    double angle = 1.0;
+    for (int i = 0; i < 100000; ++i) {
+        const double turn = turns(rng);
+        heading = SimMath::rotate(heading, turn);
+        angle += turn;
+    }
+
+    EXPECT_NEAR(std::hypot(heading.x, heading.y), 1.0, 1e-15);
+    EXPECT_NEAR(heading.x, std::cos(angle), 1e-11);
+    EXPECT_NEAR(heading.y, std::sin(angle), 1e-11);
+}
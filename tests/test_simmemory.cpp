@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "SimEnvironment.h"
+#include "SimMemory.h"
+#include "SimRandom.h"
+#include "sim_scenario.h"
+
+TEST(MemoryTelemetryTests, phaseMeterChargesConsecutivePhases)
+{
+    MemoryTelemetry telemetry;
+    AllocationCounters& counters = SimMemory::threadCounters();
+    {
+        MemoryTelemetry::PhaseMeter meter(&telemetry, MemoryReport::PhaseFood);
+        counters.allocations += 2;
+        counters.bytes += 64;
+        meter.next(MemoryReport::PhaseBirths);
+        counters.allocations += 1;
+        counters.bytes += 16;
+    }
+    telemetry.endTick(7, MemoryTelemetry::Footprint());
+
+    const MemoryReport& report = telemetry.report();
+    EXPECT_EQ(report.phases[MemoryReport::PhaseFood].allocations, 2u);
+    EXPECT_EQ(report.phases[MemoryReport::PhaseFood].bytes, 64u);
+    EXPECT_EQ(report.phases[MemoryReport::PhaseCreatures].allocations, 0u);
+    EXPECT_EQ(report.phases[MemoryReport::PhaseBirths].allocations, 1u);
+    EXPECT_EQ(report.total().bytes, 80u);
+    EXPECT_EQ(report.peakTickAllocations, 3u);
+    EXPECT_EQ(report.peakTick, 7);
+    EXPECT_EQ(report.ticks, 1);
+}
+
+TEST(MemoryTelemetryTests, nullTelemetryMetersNothing)
+{
+    AllocationCounters& counters = SimMemory::threadCounters();
+    const AllocationCounters before = counters;
+    {
+        MemoryTelemetry::PhaseMeter meter(nullptr, MemoryReport::PhaseFood);
+        meter.next(MemoryReport::PhaseRemoval);
+        meter.stop();
+    }
+    EXPECT_EQ(counters.allocations, before.allocations);
+    EXPECT_EQ(counters.bytes, before.bytes);
+
+    // A stopped meter takes the same path and must not charge later allocations.
+    MemoryTelemetry telemetry;
+    {
+        MemoryTelemetry::PhaseMeter meter(&telemetry, MemoryReport::PhaseFood);
+        counters.allocations += 2;
+        meter.stop();
+        counters.allocations += 5;
+        meter.next(MemoryReport::PhaseRemoval);
+        counters.allocations += 1;
+    }
+    telemetry.endTick(1, MemoryTelemetry::Footprint());
+
+    const MemoryReport& report = telemetry.report();
+    EXPECT_EQ(report.phases[MemoryReport::PhaseFood].allocations, 2u);
+    EXPECT_EQ(report.phases[MemoryReport::PhaseRemoval].allocations, 0u);
+    EXPECT_EQ(report.total().allocations, 2u);
+}
+
+TEST(MemoryTelemetryTests, environmentSamplesFootprintEveryTick)
+{
+    SimRandom::seed(3);
+    MemoryTelemetry telemetry;
+    Environment environment = SimScenario::world(640, 360);
+    environment.memoryTelemetry = &telemetry;
+    SimScenario::populate(environment, { SimScenario::herbivores(30) });
+    SimScenario::run(environment, 40);
+    telemetry.finish();
+
+    const MemoryReport& report = telemetry.report();
+    EXPECT_TRUE(report.enabled);
+    EXPECT_EQ(report.ticks, 40);
+    EXPECT_GE(report.peakCreatures, 30);
+    EXPECT_GT(report.peakFood, 0);
+    EXPECT_GE(report.bytesPerCreature, static_cast<double>(sizeof(Creature)));
+    EXPECT_GE(report.bytesPerFood, static_cast<double>(sizeof(Food)));
+#ifdef __linux__
+    EXPECT_GT(report.peakResidentBytes, 0u);
+#endif
+}
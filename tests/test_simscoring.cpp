@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "SimScoring.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct CandidateSet {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> energy;
+    std::vector<int> competitors;
+
+    FoodCandidates view() const
+    {
+        FoodCandidates candidates;
+        candidates.x = x.data();
+        candidates.y = y.data();
+        candidates.energy = energy.data();
+        candidates.competitors = competitors.data();
+        candidates.count = static_cast<int>(x.size());
+        return candidates;
+    }
+};
+
+CandidateSet makeCandidates(std::mt19937& rng, int count)
+{
+    std::uniform_real_distribution<double> position(0.0, 1280.0);
+    std::uniform_int_distribution<int> competitors(0, 4);
+    CandidateSet set;
+    for (int i = 0; i < count; ++i) {
+        set.x.push_back(position(rng));
+        set.y.push_back(position(rng));
+        set.energy.push_back(rng() % 5 == 0 ? -std::numeric_limits<double>::infinity() : 15.0);
+        set.competitors.push_back(competitors(rng));
+    }
+    return set;
+}
+
+}
+
+TEST(FoodScoringTests, avx2MatchesScalar)
+{
+    if (!FoodScoring::hasAvx2()) {
+        GTEST_SKIP() << "CPU without AVX2";
+    }
+
+    std::mt19937 rng(3);
+    for (int round = 0; round < 500; ++round) {
+        const CandidateSet set = makeCandidates(rng, round % 37);
+        const double x = (rng() % 1280) + 0.25;
+        const double y = (rng() % 1280) + 0.5;
+        const int focus = set.x.empty() ? -1 : static_cast<int>(rng() % (set.x.size() + 1)) - 1;
+        const double weight = round % 2 ? 2.0 : 1.0;
+
+        const FoodPick expected = FoodScoring::scalar(set.view(), x, y, focus, weight);
+        const FoodPick actual = FoodScoring::avx2(set.view(), x, y, focus, weight);
+        ASSERT_EQ(actual.index, expected.index) << "round " << round;
+        ASSERT_EQ(actual.score, expected.score) << "round " << round;
+    }
+}
+
+TEST(FoodScoringTests, tiesPickLowestIndex)
+{
+    // Identical candidates in every lane and in the scalar tail.
+    CandidateSet set;
+    for (int i = 0; i < 11; ++i) {
+        set.x.push_back(10.0);
+        set.y.push_back(0.0);
+        set.energy.push_back(i < 2 ? -std::numeric_limits<double>::infinity() : 15.0);
+        set.competitors.push_back(0);
+    }
+
+    EXPECT_EQ(bestFoodCandidate(set.view(), 0.0, 0.0, -1, 1.0).index, 2);
+    EXPECT_EQ(bestFoodCandidate(set.view(), 0.0, 0.0, 9, 1.0).index, 9);
+    EXPECT_EQ(FoodScoring::scalar(set.view(), 0.0, 0.0, -1, 1.0).index, 2);
+}
+
+TEST(FoodScoringTests, skipsEatenFood)
+{
+    CandidateSet set;
+    for (int i = 0; i < 6; ++i) {
+        set.x.push_back(1.0);
+        set.y.push_back(1.0);
+        set.energy.push_back(-std::numeric_limits<double>::infinity());
+        set.competitors.push_back(0);
+    }
+
+    EXPECT_EQ(bestFoodCandidate(set.view(), 0.0, 0.0, 3, 2.0).index, -1);
+}
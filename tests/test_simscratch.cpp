@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "SimEnvironment.h"
+#include "SimScratch.h"
+#include "sim_scenario.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<long> g_allocations{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+TEST(ScratchArenaTests, resetMergesOverflowBlocks)
+{
+    ScratchArena arena(256);
+    {
+        std::pmr::vector<int> values(&arena);
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+    }
+    EXPECT_GT(arena.blockCount(), 1);
+    const std::size_t peak = arena.capacity();
+
+    arena.reset();
+    EXPECT_EQ(arena.blockCount(), 1);
+    EXPECT_EQ(arena.capacity(), peak);
+    EXPECT_EQ(arena.bytesUsed(), 0u);
+}
+
+TEST(ScratchArenaTests, steadyStateTicksDoNotAllocate)
+{
+    CreatureSettings herbivore = SimScenario::herbivores(40);
+    herbivore.matingHungerThreshold = 1000;
+
+    // No food respawn, no mating and no predators: nothing is born, spawned or dies.
+    Environment environment(0.0, 1.0, 15.0, 640, 360);
+    SimScenario::populate(environment, { herbivore });
+    SimScenario::run(environment, 10);
+
+    const long before = g_allocations.load();
+    SimScenario::run(environment, 100);
+    EXPECT_EQ(g_allocations.load() - before, 0);
+    EXPECT_EQ(environment.creatures.size(), 40u);
+}
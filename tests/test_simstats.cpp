@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "SimStats.h"
+
+TEST(StatsPyramidTests, tickLevelKeepsExactValues)
+{
+    StatsPyramid stats(1, 16, 8);
+    for (int i = 0; i < 10; i++) {
+        const double v = i;
+        stats.record(&v);
+    }
+
+    ASSERT_EQ(stats.levelCount(), 1);
+    const auto values = stats.series(0, 0, StatsPyramid::Stat::Sum, 0, 10);
+    ASSERT_EQ(values.size(), 10u);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_DOUBLE_EQ(values[i], i);
+    }
+}
+
+TEST(StatsPyramidTests, coarserLevelsAggregateAndStayBounded)
+{
+    StatsPyramid stats(2, 16, 8);
+    const int ticks = 16 * 8 * 8 + 5;
+    for (int i = 0; i < ticks; i++) {
+        const double values[2] = { static_cast<double>(i), 1.0 };
+        stats.record(values);
+    }
+
+    EXPECT_EQ(stats.tickCount(), ticks);
+    EXPECT_EQ(stats.levelCount(), 4);
+
+    const int top = stats.levelCount() - 1;
+    EXPECT_EQ(stats.firstBucket(top), 0);
+    double total = 0.0;
+    for (double v : stats.series(top, 1, StatsPyramid::Stat::Sum, 0, ticks)) {
+        total += v;
+    }
+    EXPECT_DOUBLE_EQ(total, ticks);
+
+    // Bucket 1 of the x8 level covers ticks 8..15 once the tick level has wrapped.
+    EXPECT_DOUBLE_EQ(stats.value(1, stats.firstBucket(1), 0, StatsPyramid::Stat::Min),
+                     stats.firstBucket(1) * 8.0);
+    EXPECT_DOUBLE_EQ(stats.value(1, stats.firstBucket(1), 0, StatsPyramid::Stat::Max),
+                     stats.firstBucket(1) * 8.0 + 7.0);
+
+    for (int l = 0; l < stats.levelCount(); l++) {
+        EXPECT_LE(stats.endBucket(l) - stats.firstBucket(l), stats.capacity());
+    }
+}
+
+TEST(StatsPyramidTests, bestLevelZoomsToTicks)
+{
+    StatsPyramid stats(1, 64, 8);
+    for (int i = 0; i < 4000; i++) {
+        const double v = 1.0;
+        stats.record(&v);
+    }
+
+    EXPECT_EQ(stats.bestLevel(3990, 4000, 64), 0);
+    EXPECT_EQ(stats.bestLevel(0, 4000, 64), stats.levelCount() - 1);
+    EXPECT_GT(stats.bestLevel(0, 4000, 64), 0);
+}
+
+TEST(StatsPyramidTests, restoreReproducesSavedLevels)
+{
+    StatsPyramid stats(2, 16, 8);
+    for (int i = 0; i < 300; i++) {
+        const double values[2] = { static_cast<double>(i), static_cast<double>(i % 7) };
+        stats.record(values);
+    }
+
+    std::vector<StatsPyramid::Level> levels;
+    for (int l = 0; l < stats.levelCount(); l++) {
+        levels.push_back(stats.level(l));
+    }
+
+    StatsPyramid copy(2, 16, 8);
+    ASSERT_TRUE(copy.restore(stats.tickCount(), levels));
+    EXPECT_EQ(copy.tickCount(), stats.tickCount());
+    ASSERT_EQ(copy.levelCount(), stats.levelCount());
+    for (int l = 0; l < stats.levelCount(); l++) {
+        EXPECT_EQ(copy.series(l, 1, StatsPyramid::Stat::Max, 0, 300),
+                  stats.series(l, 1, StatsPyramid::Stat::Max, 0, 300));
+    }
+
+    StatsPyramid mismatched(3, 16, 8);
+    EXPECT_FALSE(mismatched.restore(stats.tickCount(), levels));
+    EXPECT_EQ(mismatched.tickCount(), 0);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "SimCreature.h"
+#include "SimStopConditions.h"
+#include "SimTraits.h"
+
+#include <vector>
+
+namespace {
+
+struct TwoSpecies {
+    CreatureSettings config;
+    TraitHistograms traits;
+    SpeciesPrototype grazers;
+    SpeciesPrototype hunters;
+
+    TwoSpecies()
+    {
+        grazers.index = traits.addSpecies(config);
+        hunters.index = traits.addSpecies(config);
+    }
+};
+
+}
+
+TEST(StopConditionsTests, allExtinctAlwaysStops)
+{
+    TwoSpecies world;
+    StopConditions stop(StopConditionSettings(), world.traits.speciesCount());
+    Creature grazer(1, 0.0, 0.0, world.config, world.grazers);
+    world.traits.add(grazer);
+    EXPECT_EQ(stop.check(world.traits, 1), StopConditions::None);
+
+    world.traits.remove(grazer);
+    EXPECT_EQ(stop.check(world.traits, 2), StopConditions::AllExtinct);
+    EXPECT_EQ(stop.tick(), 2);
+    EXPECT_STREQ(StopConditions::reasonName(stop.reason()), "allExtinct");
+}
+
+TEST(StopConditionsTests, speciesExtinctionIgnoresSpeciesThatNeverLived)
+{
+    TwoSpecies world;
+    StopConditionSettings settings;
+    settings.anySpeciesExtinct = true;
+    StopConditions stop(settings, world.traits.speciesCount());
+
+    Creature grazer(1, 0.0, 0.0, world.config, world.grazers);
+    Creature hunter(2, 0.0, 0.0, world.config, world.hunters);
+    world.traits.add(grazer);
+    EXPECT_EQ(stop.check(world.traits, 1), StopConditions::None);
+
+    world.traits.add(hunter);
+    EXPECT_EQ(stop.check(world.traits, 2), StopConditions::None);
+    world.traits.remove(hunter);
+    EXPECT_EQ(stop.check(world.traits, 3), StopConditions::SpeciesExtinct);
+    EXPECT_EQ(stop.species(), world.hunters.index);
+}
+
+TEST(StopConditionsTests, speciesSetStopsWhenEveryMemberIsExtinct)
+{
+    TwoSpecies world;
+    StopConditionSettings settings;
+    settings.extinctSet = { world.hunters.index };
+    StopConditions stop(settings, world.traits.speciesCount());
+
+    Creature grazer(1, 0.0, 0.0, world.config, world.grazers);
+    Creature hunter(2, 0.0, 0.0, world.config, world.hunters);
+    world.traits.add(grazer);
+    world.traits.add(hunter);
+    EXPECT_EQ(stop.check(world.traits, 1), StopConditions::None);
+
+    world.traits.remove(hunter);
+    EXPECT_EQ(stop.check(world.traits, 2), StopConditions::SpeciesSetExtinct);
+    // The reason sticks once reported.
+    world.traits.add(hunter);
+    EXPECT_EQ(stop.check(world.traits, 3), StopConditions::SpeciesSetExtinct);
+    EXPECT_EQ(stop.tick(), 2);
+}
+
+TEST(StopConditionsTests, steadyStateNeedsTwoMatchingWindows)
+{
+    TwoSpecies world;
+    StopConditionSettings settings;
+    settings.steadyWindow = 4;
+    settings.steadyTolerance = 0.02;
+    StopConditions stop(settings, world.traits.speciesCount());
+
+    std::vector<Creature> grazers;
+    for (int id = 0; id < 40; ++id) {
+        grazers.emplace_back(id, 0.0, 0.0, world.config, world.grazers);
+    }
+    // A growing population is never steady.
+    int tick = 0;
+    for (int count = 1; count <= 20; ++count) {
+        world.traits.add(grazers[count - 1]);
+        ASSERT_EQ(stop.check(world.traits, ++tick), StopConditions::None);
+    }
+
+    // Oscillating between 20 and 21 settles once both windows hold the same
+    // samples: ticks 20-23 and 24-27 each average 20.5.
+    StopConditions::Reason reason = StopConditions::None;
+    for (int i = 0; i < 20 && reason == StopConditions::None; ++i) {
+        if (i % 2 == 0) {
+            world.traits.add(grazers[20]);
+        } else {
+            world.traits.remove(grazers[20]);
+        }
+        reason = stop.check(world.traits, ++tick);
+    }
+    EXPECT_EQ(reason, StopConditions::SteadyState);
+    EXPECT_EQ(stop.tick(), 27);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "SimTrace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+int countOf(const std::string& text, const std::string& needle)
+{
+    int count = 0;
+    for (auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) {
+        count += 1;
+    }
+    return count;
+}
+
+}
+
+TEST(SimTraceTests, writesSpansFromEveryThread)
+{
+#ifndef CREATURE_SIM_TRACING
+    GTEST_SKIP() << "tracing is compiled out";
+#endif
+    SimTrace::start();
+    {
+        SimTrace::Span span("test", "first");
+        span.next("second");
+    }
+    std::thread worker([]() {
+        SimTrace::setThreadName("worker");
+        SimTrace::Span span("test", "on worker");
+    });
+    worker.join();
+    SimTrace::stop();
+    {
+        SimTrace::Span ignored("test", "after stop");
+    }
+
+    const std::string path = "simtrace_test.json";
+    ASSERT_TRUE(SimTrace::writeChromeJson(path));
+    const std::string json = readFile(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\"", 0), 0u);
+    EXPECT_EQ(countOf(json, "\"ph\":\"X\""), 3);
+    EXPECT_EQ(countOf(json, "\"name\":\"first\""), 1);
+    EXPECT_EQ(countOf(json, "\"name\":\"second\""), 1);
+    EXPECT_EQ(countOf(json, "\"name\":\"on worker\""), 1);
+    EXPECT_EQ(countOf(json, "\"name\":\"after stop\""), 0);
+    EXPECT_EQ(countOf(json, "\"args\":{\"name\":\"worker\"}"), 1);
+}
+
+TEST(SimTraceTests, ringKeepsNewestEvents)
+{
+#ifndef CREATURE_SIM_TRACING
+    GTEST_SKIP() << "tracing is compiled out";
+#endif
+    SimTrace::start(4);
+    for (int i = 0; i < 10; ++i) {
+        SimTrace::Span span("test", i < 6 ? "old" : "new");
+    }
+    SimTrace::stop();
+
+    const std::string path = "simtrace_ring_test.json";
+    ASSERT_TRUE(SimTrace::writeChromeJson(path));
+    const std::string json = readFile(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(countOf(json, "\"name\":\"old\""), 0);
+    EXPECT_EQ(countOf(json, "\"name\":\"new\""), 4);
+}
+
+TEST(SimTraceTests, exitedThreadsHandTheirBufferOn)
+{
+#ifndef CREATURE_SIM_TRACING
+    GTEST_SKIP() << "tracing is compiled out";
+#endif
+    SimTrace::start();
+    for (int i = 0; i < 8; ++i) {
+        std::thread worker([]() {
+            SimTrace::Span span("test", "short-lived");
+        });
+        worker.join();
+    }
+    SimTrace::stop();
+
+    const std::string path = "simtrace_reuse_test.json";
+    ASSERT_TRUE(SimTrace::writeChromeJson(path));
+    const std::string json = readFile(path);
+    std::remove(path.c_str());
+
+    // Every event survives, on the one buffer the threads passed along.
+    const std::string needle = "\"name\":\"short-lived\",\"pid\":1,\"tid\":";
+    std::set<int> tids;
+    for (auto at = json.find(needle); at != std::string::npos; at = json.find(needle, at + 1)) {
+        tids.insert(std::stoi(json.substr(at + needle.size())));
+    }
+    EXPECT_EQ(countOf(json, "\"name\":\"short-lived\""), 8);
+    EXPECT_EQ(tids.size(), 1u);
+}
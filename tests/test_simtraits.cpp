@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include "SimCreature.h"
+#include "SimTraits.h"
+
+TEST(TraitHistogramsTests, addAndRemoveTrackPopulation)
+{
+    CreatureSettings config;
+    config.baseSpeed = 2.0;
+    config.litterSize = 3;
+
+    TraitHistograms traits;
+    SpeciesPrototype prototype;
+    prototype.index = traits.addSpecies(config);
+    const int species = prototype.index;
+
+    Creature slow(1, 0.0, 0.0, config, prototype);
+    Creature fast(2, 0.0, 0.0, config, prototype);
+    fast.baseSpeed = 3.0;
+
+    traits.add(slow);
+    traits.add(fast);
+    EXPECT_EQ(traits.population(species), 2);
+    EXPECT_DOUBLE_EQ(traits.mean(species, TraitHistograms::BaseSpeed), 2.5);
+    EXPECT_EQ(traits.counts(species, TraitHistograms::LitterSize)[2], 2);
+
+    traits.remove(slow);
+    EXPECT_EQ(traits.population(species), 1);
+    EXPECT_DOUBLE_EQ(traits.mean(species, TraitHistograms::BaseSpeed), 3.0);
+
+    int total = 0;
+    for (int count : traits.counts(species, TraitHistograms::BaseSpeed)) {
+        total += count;
+    }
+    EXPECT_EQ(total, 1);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "DataStore.h"
+#include "WorkerProtocol.h"
+
+#include <QProcess>
+
+TEST(WorkerProtocolTests, takeFrameWaitsForCompleteFrames)
+{
+    const QByteArray first = WorkerProtocol::makeFrame(WorkerProtocol::FrameProgress, QByteArray("\n\x1a\r\n", 4));
+    const QByteArray second = WorkerProtocol::makeFrame(WorkerProtocol::FrameResult, QByteArray());
+    const QByteArray stream = first + second;
+
+    QByteArray buffer;
+    char type = 0;
+    QByteArray payload;
+    for (int i = 0; i < first.size() - 1; ++i) {
+        buffer.append(stream.at(i));
+        EXPECT_FALSE(WorkerProtocol::takeFrame(buffer, type, payload)) << i;
+    }
+    buffer.append(stream.mid(first.size() - 1));
+
+    ASSERT_TRUE(WorkerProtocol::takeFrame(buffer, type, payload));
+    EXPECT_EQ(type, WorkerProtocol::FrameProgress);
+    EXPECT_EQ(payload, QByteArray("\n\x1a\r\n", 4));
+    ASSERT_TRUE(WorkerProtocol::takeFrame(buffer, type, payload));
+    EXPECT_EQ(type, WorkerProtocol::FrameResult);
+    EXPECT_TRUE(payload.isEmpty());
+    EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST(WorkerProtocolTests, framesSurviveAWorkerPipe)
+{
+    // Every byte value, including the ones a text-mode stream rewrites (0x0A)
+    // or treats as end of file (0x1A), and a length prefix made of them.
+    QByteArray raw;
+    for (int b = 0; b < 256; ++b) {
+        raw.append(static_cast<char>(b));
+    }
+    raw.append(QByteArray(0x0A0A - raw.size() - 1, '\x1a'));
+
+    SimulationResult result;
+    result.status = "success";
+    result.stopReason = "creatureBudget";
+    result.failureReason = "line one\nline two\r\n\x1a";
+    result.ticksSimulated = 0x0A1A0D0A;
+    result.creatureCount = { 10.0, 26.0, 13.0 };
+    result.birthsRefused = 0x1A0A;
+    result.stats = StatsPyramid(2, 16, 2);
+    for (int tick = 0; tick < 40; ++tick) {
+        const double values[2] = { 10.0 + tick, 26.0 };
+        result.stats.record(values);
+    }
+
+    QProcess worker;
+    worker.start(QString::fromUtf8(CREATURE_SIM_WORKER_ECHO), QStringList());
+    ASSERT_TRUE(worker.waitForStarted());
+    worker.write(WorkerProtocol::makeFrame(WorkerProtocol::FrameProgress, raw));
+    worker.write(WorkerProtocol::makeFrame(WorkerProtocol::FrameResult, DataStore::serializeResultBinary(result)));
+    worker.closeWriteChannel();
+    ASSERT_TRUE(worker.waitForFinished(30000));
+    EXPECT_EQ(worker.exitStatus(), QProcess::NormalExit);
+    EXPECT_EQ(worker.exitCode(), 0);
+
+    QByteArray buffer = worker.readAllStandardOutput();
+    char type = 0;
+    QByteArray payload;
+    ASSERT_TRUE(WorkerProtocol::takeFrame(buffer, type, payload));
+    EXPECT_EQ(type, WorkerProtocol::FrameProgress);
+    EXPECT_EQ(payload, raw);
+
+    ASSERT_TRUE(WorkerProtocol::takeFrame(buffer, type, payload));
+    EXPECT_EQ(type, WorkerProtocol::FrameResult);
+    SimulationResult echoed;
+    QString error;
+    ASSERT_TRUE(DataStore::deserializeResultBinary(payload, echoed, &error)) << error.toStdString();
+    EXPECT_EQ(echoed.status, result.status);
+    EXPECT_EQ(echoed.stopReason, result.stopReason);
+    EXPECT_EQ(echoed.failureReason, result.failureReason);
+    EXPECT_EQ(echoed.ticksSimulated, result.ticksSimulated);
+    EXPECT_EQ(echoed.creatureCount, result.creatureCount);
+    EXPECT_EQ(echoed.birthsRefused, result.birthsRefused);
+    EXPECT_EQ(echoed.stats.tickCount(), result.stats.tickCount());
+    EXPECT_TRUE(buffer.isEmpty());
+}
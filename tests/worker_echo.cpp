@@ -0,0 +1,43 @@
+// Stand-in worker for test_workerprotocol.cpp: opens stdio the way
+// WorkerPool::runWorker does and sends every frame back. Result frames are
+// decoded and re-encoded on the way so the codec crosses the pipe both ways.
+#include "DataStore.h"
+#include "WorkerProtocol.h"
+
+#include <QFile>
+#include <QtEndian>
+
+int main()
+{
+    QFile input;
+    QFile output;
+    if (!WorkerProtocol::openStdio(input, output)) {
+        return 1;
+    }
+
+    for (;;) {
+        char header[4];
+        if (!WorkerProtocol::readExactly(input, header, sizeof(header))) {
+            return 0;
+        }
+
+        const quint32 length = qFromBigEndian<quint32>(header);
+        QByteArray frame(static_cast<qsizetype>(length), Qt::Uninitialized);
+        if (length == 0 || !WorkerProtocol::readExactly(input, frame.data(), length)) {
+            return 1;
+        }
+
+        const char type = frame.at(0);
+        QByteArray payload = frame.mid(1);
+        if (type == WorkerProtocol::FrameResult) {
+            SimulationResult result;
+            QString error;
+            if (!DataStore::deserializeResultBinary(payload, result, &error)) {
+                return 2;
+            }
+            payload = DataStore::serializeResultBinary(result);
+        }
+        output.write(WorkerProtocol::makeFrame(type, payload));
+        output.flush();
+    }
+}
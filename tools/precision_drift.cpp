@@ -0,0 +1,209 @@
+// Precision drift harness.
+//
+// Runs the reference scenarios over a fixed set of seeds and prints one CSV row
+// per scenario, seed and metric. Built twice by the precision_drift target: the
+// double build writes the reference file, the float build compares against it
+// and reports, per metric, the shift of the mean in units of the reference
+// run-to-run spread. Individual runs diverge chaotically either way, so only
+// the distributions are compared.
+
+#include "SimEnvironment.h"
+#include "SimRandom.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kSeeds = 12;
+constexpr int kTicks = 1500;
+
+struct Scenario {
+    const char* name;
+    int width;
+    int height;
+    double respawnMultiplier;
+    int herbivores;
+    int carnivores;
+    int omnivores;
+};
+
+const Scenario kScenarios[] = {
+    { "grazers", 1280, 720, 3.0, 80, 0, 0 },
+    { "predation", 1280, 720, 3.0, 60, 8, 0 },
+    { "mixed_large", 2560, 1440, 8.0, 120, 8, 20 },
+};
+
+using Metrics = std::map<std::string, double>;
+
+void addSpecies(QVector<CreatureSettings>& config, const char* name, const char* diet, int population)
+{
+    if (population <= 0) {
+        return;
+    }
+    CreatureSettings settings;
+    settings.speciesName = name;
+    settings.dietType = diet;
+    settings.initialPopulation = population;
+    config.push_back(settings);
+}
+
+Metrics runScenario(const Scenario& scenario, unsigned int seed)
+{
+    SimRandom::seed(seed);
+
+    QVector<CreatureSettings> config;
+    addSpecies(config, "Herbivore", "herbivore", scenario.herbivores);
+    addSpecies(config, "Carnivore", "carnivore", scenario.carnivores);
+    addSpecies(config, "Omnivore", "omnivore", scenario.omnivores);
+
+    Environment environment(1.0, scenario.respawnMultiplier, 15.0, scenario.width, scenario.height);
+    environment.setupFood();
+    environment.setupCreatures(config);
+
+    double populationSum = 0.0;
+    int births = 0;
+    int deaths = 0;
+    for (int i = 0; i < kTicks && !environment.creatures.empty(); ++i) {
+        Tracking tracking(&environment.scratch);
+        environment.update(tracking);
+        populationSum += static_cast<double>(environment.creatures.size());
+        births += static_cast<int>(tracking.births.size());
+        deaths += static_cast<int>(tracking.deaths.size());
+    }
+
+    double fullness = 0.0;
+    for (const auto* creature : environment.creatures) {
+        fullness += creature->fullnessLevel;
+    }
+
+    Metrics metrics;
+    metrics["mean_population"] = populationSum / kTicks;
+    metrics["final_population"] = static_cast<double>(environment.creatures.size());
+    metrics["final_food"] = static_cast<double>(environment.foods.size());
+    metrics["births"] = births;
+    metrics["deaths"] = deaths;
+    metrics["mean_fullness"] = environment.creatures.empty() ? 0.0 : fullness / environment.creatures.size();
+    for (int s = 0; s < environment.traits.speciesCount(); ++s) {
+        const std::string species = environment.species[s].speciesName.toStdString();
+        metrics["final_" + species] = environment.traits.population(s);
+    }
+    return metrics;
+}
+
+// key: scenario/metric, value: one sample per seed.
+using Samples = std::map<std::string, std::vector<double>>;
+
+Samples runAll(FILE* csv)
+{
+    Samples samples;
+    for (const auto& scenario : kScenarios) {
+        for (int seed = 1; seed <= kSeeds; ++seed) {
+            for (const auto& [metric, value] : runScenario(scenario, static_cast<unsigned int>(seed))) {
+                samples[std::string(scenario.name) + "/" + metric].push_back(value);
+                if (csv) {
+                    std::fprintf(csv, "%s,%d,%s,%.17g\n", scenario.name, seed, metric.c_str(), value);
+                }
+            }
+        }
+    }
+    return samples;
+}
+
+bool readReference(const char* path, Samples& samples)
+{
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream row(line);
+        std::string scenario, seed, metric, value;
+        if (std::getline(row, scenario, ',') && std::getline(row, seed, ',') &&
+            std::getline(row, metric, ',') && std::getline(row, value))
+        {
+            samples[scenario + "/" + metric].push_back(std::stod(value));
+        }
+    }
+    return !samples.empty();
+}
+
+void meanAndDeviation(const std::vector<double>& values, double& mean, double& deviation)
+{
+    mean = 0.0;
+    for (double value : values) {
+        mean += value;
+    }
+    mean /= values.size();
+    double variance = 0.0;
+    for (double value : values) {
+        variance += (value - mean) * (value - mean);
+    }
+    deviation = values.size() > 1 ? std::sqrt(variance / (values.size() - 1)) : 0.0;
+}
+
+int compare(const Samples& reference, const Samples& candidate)
+{
+    std::printf("%-34s %12s %12s %9s %8s\n", "metric", "double", "float", "delta%", "sigma");
+    double worst = 0.0;
+    for (const auto& [key, expected] : reference) {
+        const auto found = candidate.find(key);
+        if (found == candidate.end()) {
+            std::printf("%-34s missing from this build\n", key.c_str());
+            continue;
+        }
+
+        double referenceMean = 0.0, referenceDeviation = 0.0, mean = 0.0, deviation = 0.0;
+        meanAndDeviation(expected, referenceMean, referenceDeviation);
+        meanAndDeviation(found->second, mean, deviation);
+        const double delta = referenceMean != 0.0 ? 100.0 * (mean - referenceMean) / referenceMean : 0.0;
+        // Shift of the mean in units of its standard error.
+        const double error = std::sqrt((referenceDeviation * referenceDeviation + deviation * deviation) / expected.size());
+        const double sigma = error > 0.0 ? (mean - referenceMean) / error : 0.0;
+        worst = std::max(worst, std::abs(sigma));
+        std::printf("%-34s %12.3f %12.3f %9.2f %8.2f\n", key.c_str(), referenceMean, mean, delta, sigma);
+    }
+    std::printf("largest shift: %.2f standard errors\n", worst);
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    const char* mode = argc > 2 ? argv[1] : "";
+    const char* path = argc > 2 ? argv[2] : nullptr;
+
+    if (std::strcmp(mode, "--write") == 0) {
+        FILE* csv = std::fopen(path, "w");
+        if (!csv) {
+            std::fprintf(stderr, "cannot write %s\n", path);
+            return 1;
+        }
+        runAll(csv);
+        std::fclose(csv);
+        std::printf("wrote %s (SimReal is %zu bytes)\n", path, sizeof(SimReal));
+        return 0;
+    }
+
+    if (std::strcmp(mode, "--compare") == 0) {
+        Samples reference;
+        if (!readReference(path, reference)) {
+            std::fprintf(stderr, "cannot read reference %s\n", path);
+            return 1;
+        }
+        std::printf("comparing against %s (SimReal is %zu bytes)\n", path, sizeof(SimReal));
+        return compare(reference, runAll(nullptr));
+    }
+
+    std::fprintf(stderr, "usage: %s --write <reference.csv> | --compare <reference.csv>\n", argv[0]);
+    return 2;
+}